@@ -39,6 +39,9 @@ public class EasyMultiSave : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"RenderCore",
+				"RHI",
+				"ImageWrapper",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -48,6 +48,8 @@ UEMSAsyncLoadGame* UEMSAsyncLoadGame::AsyncLoadActors(UObject* WorldContextObjec
 			LoadTask->EMS = EMSObject;
 			LoadTask->bIsActive = true;
 
+			EMSObject->RegisterLoadTask(LoadTask);
+
 			return LoadTask;
 		}
 	}
@@ -160,6 +162,8 @@ void UEMSAsyncLoadGame::FinishLoading()
 	{
 		//Has to be a tick before broadcast.
 		bIsActive = false;
+		EMS->LogOperationCounters(TEXT("Load Game Actors"));
+		EMS->UnregisterLoadTask(this);
 
 		ClearFailTimer();
 
@@ -182,6 +186,11 @@ void UEMSAsyncLoadGame::CompleteLoadingTask()
 
 void UEMSAsyncLoadGame::FailLoadingTask()
 {
+	if (EMS)
+	{
+		EMS->UnregisterLoadTask(this);
+	}
+
 	OnFailed.Broadcast();
 	SetReadyToDestroy();
 }
@@ -194,8 +203,17 @@ void UEMSAsyncLoadGame::StartDeferredLoad()
 {
 	if (EMS)
 	{
-		SavedActors = EMS->SavedActors;
-		DeferredLoadActors();
+		//The task takes over the records, they are not needed anywhere else after loading.
+		SavedActors = MoveTemp(EMS->SavedActors);
+
+		if (UEMSPluginSettings::Get()->LoadMethod == ELoadMethod::LM_Budgeted)
+		{
+			BudgetedLoadActors();
+		}
+		else
+		{
+			DeferredLoadActors();
+		}
 	}
 }
 
@@ -238,4 +256,39 @@ void UEMSAsyncLoadGame::DeferredLoadActors()
 	}
 }
 
+void UEMSAsyncLoadGame::BudgetedLoadActors()
+{
+	if (EMS)
+	{
+		if (LoadedActorNum < SavedActors.Num())
+		{
+			const double Budget = UEMSPluginSettings::Get()->LoadTimeBudget / 1000.0;
+			const double StartTime = FPlatformTime::Seconds();
+
+			//Load at least one Actor per frame, then stop if the next one would likely exceed the budget.
+			do
+			{
+				bDeferredLoadSuccess = EMS->SpawnOrUpdateLevelActor(SavedActors[LoadedActorNum]);
+				LoadedActorNum++;
+
+				const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+				if (ElapsedTime + EMS->LoadTimings.GetAverageTime() > Budget)
+				{
+					break;
+				}
+			} 
+			while (LoadedActorNum < SavedActors.Num());
 
+			EMS->GetTimerManager().SetTimerForNextTick(this, &UEMSAsyncLoadGame::BudgetedLoadActors);
+		}
+		else
+		{
+			if (bDeferredLoadSuccess)
+			{
+				EMS->LogFinishLoadingLevel();
+			}
+
+			FinishLoading();
+		}
+	}
+}
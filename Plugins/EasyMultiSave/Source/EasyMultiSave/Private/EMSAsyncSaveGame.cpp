@@ -36,7 +36,8 @@ UEMSAsyncSaveGame* UEMSAsyncSaveGame::AsyncSaveActors(UObject* WorldContextObjec
 {
 	if (UEMSObject* EMSObject = UEMSObject::Get(WorldContextObject))
 	{
-		if (!EMSObject->IsAsyncSaveOrLoadTaskActive(GetMode(Data)))
+		//Saving during another save is queued, but not during loading.
+		if (!EMSObject->IsAsyncSaveOrLoadTaskActive(GetMode(Data), EAsyncCheckType::CT_Load))
 		{
 			UEMSAsyncSaveGame* SaveTask = NewObject<UEMSAsyncSaveGame>(GetTransientPackage());
 			SaveTask->WorldContextObject = WorldContextObject;
@@ -44,6 +45,10 @@ UEMSAsyncSaveGame* UEMSAsyncSaveGame::AsyncSaveActors(UObject* WorldContextObjec
 			SaveTask->Mode = GetMode(Data);
 			SaveTask->EMS = EMSObject;
 			SaveTask->bIsActive = true;
+			SaveTask->bIsQueued = false;
+			SaveTask->bIsMerged = false;
+
+			EMSObject->RegisterSaveTask(SaveTask);
 
 			return SaveTask;
 		}
@@ -53,9 +58,30 @@ UEMSAsyncSaveGame* UEMSAsyncSaveGame::AsyncSaveActors(UObject* WorldContextObjec
 }
 
 void UEMSAsyncSaveGame::Activate()
+{
+	//Queued and merged saves are started once the running save is done.
+	if (!bIsQueued && !bIsMerged)
+	{
+		StartSaveTask();
+	}
+}
+
+void UEMSAsyncSaveGame::MergeTask(UEMSAsyncSaveGame* SaveTask)
+{
+	Data |= SaveTask->Data;
+	Mode = GetMode(Data);
+
+	SaveTask->bIsMerged = true;
+	MergedTasks.Add(SaveTask);
+
+	UE_LOG(LogEasyMultiSave, Log, TEXT("Save Game Actors is active, request was merged into the queued save."));
+}
+
+void UEMSAsyncSaveGame::StartSaveTask()
 {
 	if (EMS)
 	{
+		EMS->ResetFailedWrites();
 		EMS->PrepareLoadAndSaveActors(Data);
 
 		EMS->GetTimerManager().SetTimerForNextTick(this, &UEMSAsyncSaveGame::StartSaving);
@@ -153,14 +179,60 @@ void UEMSAsyncSaveGame::FinishSaving()
 {
 	if (EMS)
 	{
+		//Wait for the background file writes without blocking.
+		if (EMS->HasPendingWrites())
+		{
+			EMS->GetTimerManager().SetTimerForNextTick(this, &UEMSAsyncSaveGame::FinishSaving);
+			return;
+		}
+
 		bIsActive = false;
-		EMS->GetTimerManager().SetTimerForNextTick(this, &UEMSAsyncSaveGame::CompleteSavingTask);
+		EMS->LogOperationCounters(TEXT("Save Game Actors"));
+		EMS->UnregisterSaveTask(this);
+
+		if (EMS->HasFailedWrites())
+		{
+			UE_LOG(LogEasyMultiSave, Warning, TEXT("Save Game Actors failed, not all files could be written."));
+			EMS->GetTimerManager().SetTimerForNextTick(this, &UEMSAsyncSaveGame::FailSavingTask);
+		}
+		else
+		{
+			EMS->GetTimerManager().SetTimerForNextTick(this, &UEMSAsyncSaveGame::CompleteSavingTask);
+		}
 	}
 }
 
 void UEMSAsyncSaveGame::CompleteSavingTask()
 {
 	OnCompleted.Broadcast();
+
+	for (UEMSAsyncSaveGame* MergedTask : MergedTasks)
+	{
+		if (MergedTask)
+		{
+			MergedTask->bIsActive = false;
+			MergedTask->CompleteSavingTask();
+		}
+	}
+
+	MergedTasks.Empty();
+	SetReadyToDestroy();
+}
+
+void UEMSAsyncSaveGame::FailSavingTask()
+{
+	OnFailed.Broadcast();
+
+	for (UEMSAsyncSaveGame* MergedTask : MergedTasks)
+	{
+		if (MergedTask)
+		{
+			MergedTask->bIsActive = false;
+			MergedTask->FailSavingTask();
+		}
+	}
+
+	MergedTasks.Empty();
 	SetReadyToDestroy();
 }
 
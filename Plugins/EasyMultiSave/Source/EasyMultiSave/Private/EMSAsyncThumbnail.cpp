@@ -0,0 +1,48 @@
+//Easy Multi Save - Copyright (C) 2022 by Michael Hegemann.  
+
+#include "EMSAsyncThumbnail.h"
+#include "EMSObject.h"
+
+UEMSAsyncThumbnail* UEMSAsyncThumbnail::AsyncImportSaveThumbnail(UObject* WorldContextObject, const FString& SaveGameName)
+{
+	if (UEMSObject* EMSObject = UEMSObject::Get(WorldContextObject))
+	{
+		UEMSAsyncThumbnail* ThumbnailTask = NewObject<UEMSAsyncThumbnail>(GetTransientPackage());
+		ThumbnailTask->WorldContextObject = WorldContextObject;
+		ThumbnailTask->EMS = EMSObject;
+		ThumbnailTask->SaveGameName = SaveGameName;
+		return ThumbnailTask;
+	}
+
+	return nullptr;
+}
+
+void UEMSAsyncThumbnail::Activate()
+{
+	if (EMS)
+	{
+		TWeakObjectPtr<UEMSAsyncThumbnail> WeakThis(this);
+
+		EMS->ImportSaveThumbnailAsync(SaveGameName, [WeakThis](UTexture2D* Thumbnail)
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->CompleteThumbnailTask(Thumbnail);
+			}
+		});
+	}
+}
+
+void UEMSAsyncThumbnail::CompleteThumbnailTask(UTexture2D* Thumbnail)
+{
+	if (Thumbnail)
+	{
+		OnCompleted.Broadcast(Thumbnail);
+	}
+	else
+	{
+		OnFailed.Broadcast();
+	}
+
+	SetReadyToDestroy();
+}
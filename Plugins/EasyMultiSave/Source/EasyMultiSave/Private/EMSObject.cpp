@@ -3,25 +3,49 @@
 #include "EMSObject.h"
 #include "EMSFunctionLibrary.h"
 #include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
 #include "EMSActorSaveInterface.h"
 #include "Misc/FileHelper.h"
 #include "Engine/Engine.h"
 #include "EngineUtils.h"
-#include "UObject/UObjectIterator.h"
 #include "Engine/LevelScriptActor.h"
 #include "Engine/GameInstance.h"
 #include "GameFramework/GameStateBase.h"
 #include "GameFramework/PlayerState.h"
 #include "Serialization/ArchiveSaveCompressedProxy.h"
 #include "Serialization/ArchiveLoadCompressedProxy.h"
+#include "Misc/Compression.h"
 #include "TimerManager.h"
 #include "EMSPluginSettings.h"
 #include "Kismet/GameplayStatics.h"
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeLock.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 #include "Runtime/Launch/Resources/Version.h"
 #include "SaveGameSystem.h"
 #include "PlatformFeatures.h"
 #include "ImageUtils.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+#include "RenderingThread.h"
+#include "TextureResource.h"
+#include "Engine/Texture2D.h"
+
+DECLARE_CYCLE_STAT(TEXT("Prepare Actors"), STAT_EMS_PrepareActors, STATGROUP_EasyMultiSave);
+DECLARE_CYCLE_STAT(TEXT("Save Level Actors"), STAT_EMS_SaveLevelActors, STATGROUP_EasyMultiSave);
+DECLARE_CYCLE_STAT(TEXT("Load Level Actors"), STAT_EMS_LoadLevelActors, STATGROUP_EasyMultiSave);
+DECLARE_CYCLE_STAT(TEXT("Save Player Actors"), STAT_EMS_SavePlayerActors, STATGROUP_EasyMultiSave);
+DECLARE_CYCLE_STAT(TEXT("Load Player Actors"), STAT_EMS_LoadPlayerActors, STATGROUP_EasyMultiSave);
+DECLARE_CYCLE_STAT(TEXT("Spawn Level Actor"), STAT_EMS_SpawnLevelActor, STATGROUP_EasyMultiSave);
+DECLARE_CYCLE_STAT(TEXT("Save Binary Archive"), STAT_EMS_SaveBinaryArchive, STATGROUP_EasyMultiSave);
+DECLARE_CYCLE_STAT(TEXT("Load Binary Archive"), STAT_EMS_LoadBinaryArchive, STATGROUP_EasyMultiSave);
+DECLARE_CYCLE_STAT(TEXT("Compress"), STAT_EMS_Compress, STATGROUP_EasyMultiSave);
+DECLARE_CYCLE_STAT(TEXT("Decompress"), STAT_EMS_Decompress, STATGROUP_EasyMultiSave);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Uncompressed Bytes"), STAT_EMS_UncompressedBytes, STATGROUP_EasyMultiSave);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Compressed Bytes"), STAT_EMS_CompressedBytes, STATGROUP_EasyMultiSave);
 
 /**
 Initalization
@@ -38,6 +62,28 @@ void UEMSObject::Initialize(FSubsystemCollectionBase& Collection)
 
 	UE_LOG(LogEasyMultiSave, Log, TEXT("Easy Multi Save Initialized"));
 	UE_LOG(LogEasyMultiSave, Log, TEXT("Current Save Game Slot is: %s"), *GetCurrentSaveGameName());
+
+	FWorldDelegates::OnWorldCleanup.AddUObject(this, &UEMSObject::OnWorldCleanup);
+}
+
+void UEMSObject::Deinitialize()
+{
+	FWorldDelegates::OnWorldCleanup.RemoveAll(this);
+
+	//Make sure all save files are on disk before shutting down.
+	WaitForPendingWrites();
+
+	Super::Deinitialize();
+}
+
+void UEMSObject::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	//Timers of running tasks are gone with the world, so they would never finish.
+	if (World && World->GetGameInstance() == GetGameInstance())
+	{
+		SaveTasks.Empty();
+		LoadTasks.Empty();
+	}
 }
 
 UEMSObject* UEMSObject::Get(UObject* WorldContextObject)
@@ -144,6 +190,8 @@ void UEMSObject::DeleteCustomSave(UEMSCustomSaveGame* SaveGame)
 	const bool bUseSlot = SaveGame->bUseSaveSlot;
 	const FString CustomSaveName = SaveGame->SaveGameName;
 	const FString SaveFile = CustomSaveFile(CustomSaveName, bUseSlot);
+
+	WaitForPendingWrite(SaveFile);
 	
 	bool bSuccess = false;
 
@@ -207,7 +255,7 @@ void UEMSObject::SaveSlotInfoObject()
 		UEMSInfoSaveGame* SaveGame = GetSlotInfoObject();
 		if (SaveGame)
 		{
-			//GetSortedSaveSlots() only uses the file data, this uses actual saved data.
+			//Also written to the slot index, which is used for sorting.
 			SaveGame->SlotInfo.Name = SaveGameName;
 			SaveGame->SlotInfo.TimeStamp = FDateTime::Now();
 			SaveGame->SlotInfo.Level = GetLevelName();
@@ -228,6 +276,7 @@ void UEMSObject::SaveSlotInfoObject()
 			}
 
 			SaveObject(*SlotInfoSaveFile(), SaveGame);
+			UpdateSlotIndex(SaveGame->SlotInfo);
 		}
 	}
 }
@@ -247,12 +296,16 @@ void UEMSObject::SetCurrentSaveGameName(const FString & SaveGameName)
 
 TArray<FString> UEMSObject::GetSortedSaveSlots() const
 {
-	if (IsConsoleFileSystem())
+	const TArray<FString> SlotNames = IsConsoleFileSystem() ? GetSaveSlotsConsole() : GetSaveSlotsDesktop();
+	ValidateSlotIndex(SlotNames);
+
+	TArray<FString> SaveSlotNames;
+	for (const FSaveSlotIndexEntry& Entry : SlotIndex.Slots)
 	{
-		return GetSaveSlotsConsole();
+		SaveSlotNames.Add(Entry.Name);
 	}
 
-	return GetSaveSlotsDesktop();
+	return SaveSlotNames;
 }
 
 TArray<FString> UEMSObject::GetSaveSlotsDesktop() const
@@ -260,32 +313,7 @@ TArray<FString> UEMSObject::GetSaveSlotsDesktop() const
 	TArray<FString> SaveGameNames;
 	IFileManager::Get().FindFiles(SaveGameNames, *FPaths::Combine(BaseSaveDir(), TEXT("*")), false, true);
 
-	TArray<FString> SaveSlotNames;
-	TArray<FSaveSlotInfo> SaveSlots;
-
-	for (const FString& SlotName : SaveGameNames)
-	{
-		FSaveSlotInfo SlotInfo;
-		SlotInfo.Name = SlotName;
-
-		//Use Timestamp of actual file only for sorting.
-		const FString SlotPath = SlotFilePath(SlotName);
-		SlotInfo.TimeStamp = IFileManager::Get().GetTimeStamp(*SlotPath);
-
-		SaveSlots.Add(SlotInfo);
-	}
-
-	SaveSlots.Sort([](const FSaveSlotInfo& A, const FSaveSlotInfo& B)
-	{
-		return A.TimeStamp > B.TimeStamp;
-	});
-
-	for (const FSaveSlotInfo& SlotInfo : SaveSlots)
-	{
-		SaveSlotNames.Add(SlotInfo.Name);
-	}
-	
-	return SaveSlotNames;
+	return SaveGameNames;
 }
 
 TArray<FString> UEMSObject::GetSaveSlotsConsole() const
@@ -313,32 +341,127 @@ TArray<FString> UEMSObject::GetSaveSlotsConsole() const
 		}
 	}
 
-	//Fill with proper info
-	TArray<FSaveSlotInfo> SaveSlots;
+	return SlotNames;
+}
+
+/**
+Slot Index
+**/
+
+void UEMSObject::ValidateSlotIndex(const TArray<FString>& SlotNames) const
+{
+	LoadSlotIndex();
+
+	bool bChanged = false;
+
+	//Slots that were removed outside of the plugin.
+	const TSet<FString> ExistingSlots(SlotNames);
+	const int32 RemovedNum = SlotIndex.Slots.RemoveAll([&ExistingSlots](const FSaveSlotIndexEntry& Entry)
+	{
+		return !ExistingSlots.Contains(Entry.Name);
+	});
+
+	bChanged = RemovedNum > 0;
+
+	//Only slots missing from the index need a file stat. Without an index, this is a full rescan.
 	for (const FString& SlotName : SlotNames)
 	{
-		FSaveSlotInfo SlotInfo;
-		SlotInfo.Name = SlotName;
+		if (!SlotIndex.FindSlot(SlotName))
+		{
+			FSaveSlotIndexEntry Entry;
+			Entry.Name = SlotName;
+			Entry.TimeStamp = IFileManager::Get().GetTimeStamp(*SlotFilePath(SlotName));
+			Entry.Thumbnail = ThumbnailSaveFile(SlotName);
+
+			SlotIndex.Slots.Add(Entry);
+			bChanged = true;
+		}
+	}
 
-		const FString SlotPath = SlotFilePath(SlotName);
-		SlotInfo.TimeStamp = IFileManager::Get().GetTimeStamp(*SlotPath);
+	if (bChanged)
+	{
+		SlotIndex.Sort();
+		SaveSlotIndex();
+	}
+}
 
-		SaveSlots.Add(SlotInfo);
+void UEMSObject::LoadSlotIndex() const
+{
+	//Each user has its own index.
+	if (bSlotIndexLoaded && SlotIndexUser == CurrentSaveUserName)
+	{
+		return;
 	}
 
-	SaveSlots.Sort([](const FSaveSlotInfo& A, const FSaveSlotInfo& B)
+	bSlotIndexLoaded = true;
+	SlotIndexUser = CurrentSaveUserName;
+	SlotIndex = FSaveSlotIndex();
+
+	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	if (!SaveSystem->DoesSaveGameExist(*SlotIndexFile(), PlayerIndex))
 	{
-		return A.TimeStamp > B.TimeStamp;
-	});
+		return;
+	}
 
-	//Need another copy to return the sorted list
-	TArray<FString> SaveSlotNames;
-	for (const FSaveSlotInfo& SlotInfo : SaveSlots)
+	TArray<uint8> IndexData;
+	if (SaveSystem->LoadGame(false, *SlotIndexFile(), PlayerIndex, IndexData))
 	{
-		SaveSlotNames.Add(SlotInfo.Name);
+		FMemoryReader FromBinary = FMemoryReader(IndexData, true);
+		FromBinary << SlotIndex;
+
+		//Stale or damaged index, the validation pass will rebuild it.
+		if (!SlotIndex.IsValid() || FromBinary.IsError())
+		{
+			UE_LOG(LogEasyMultiSave, Log, TEXT("Slot index is outdated and will be rebuilt"));
+			SlotIndex = FSaveSlotIndex();
+		}
 	}
+}
 
-	return SaveSlotNames;
+void UEMSObject::SaveSlotIndex() const
+{
+	FBufferArchive IndexData;
+	IndexData << SlotIndex;
+
+	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	if (!SaveSystem->SaveGame(false, *SlotIndexFile(), PlayerIndex, IndexData))
+	{
+		UE_LOG(LogEasyMultiSave, Warning, TEXT("Slot index could not be saved"));
+	}
+}
+
+void UEMSObject::UpdateSlotIndex(const FSaveSlotInfo& SlotInfo)
+{
+	LoadSlotIndex();
+
+	FSaveSlotIndexEntry Entry;
+	Entry.Name = SlotInfo.Name;
+	Entry.TimeStamp = FDateTime::UtcNow(); //File time stamps are UTC as well
+	Entry.Level = SlotInfo.Level;
+	Entry.Thumbnail = ThumbnailSaveFile(SlotInfo.Name);
+
+	SlotIndex.Slots.RemoveAll([&Entry](const FSaveSlotIndexEntry& Existing)
+	{
+		return Existing.Name == Entry.Name;
+	});
+
+	SlotIndex.Slots.Insert(Entry, 0);
+	SaveSlotIndex();
+}
+
+void UEMSObject::RemoveFromSlotIndex(const FString& SaveGameName)
+{
+	LoadSlotIndex();
+
+	const int32 RemovedNum = SlotIndex.Slots.RemoveAll([&SaveGameName](const FSaveSlotIndexEntry& Entry)
+	{
+		return Entry.Name == SaveGameName;
+	});
+
+	if (RemovedNum > 0)
+	{
+		SaveSlotIndex();
+	}
 }
 
 bool UEMSObject::DoesSaveGameExist(const FString& SaveGameName) const
@@ -349,6 +472,7 @@ bool UEMSObject::DoesSaveGameExist(const FString& SaveGameName) const
 
 void UEMSObject::DeleteAllSaveDataForSlot(const FString& SaveGameName)
 {
+	WaitForPendingWrites();
 	ClearCachedSlot();
 
 	bool bSuccess = false;
@@ -402,6 +526,12 @@ void UEMSObject::DeleteAllSaveDataForSlot(const FString& SaveGameName)
 		}
 	}
 
+	if (bSuccess)
+	{
+		RemoveFromSlotIndex(SaveGameName);
+		ThumbnailCache.Remove(ThumbnailSaveFile(SaveGameName));
+	}
+
 	//Delete the cached custom save objects
 	TMap<FString, UEMSCustomSaveGame*> TempCustomSaves = CachedCustomSaves;
 	for (auto It = TempCustomSaves.CreateIterator(); It; ++It)
@@ -437,6 +567,7 @@ void UEMSObject::SetCurrentSaveUserName(const FString& UserName)
 
 void UEMSObject::DeleteAllSaveDataForUser(const FString& UserName)
 {
+	WaitForPendingWrites();
 	ClearCachedSlot();
 	ClearCachedCustomSaves();
 
@@ -447,6 +578,10 @@ void UEMSObject::DeleteAllSaveDataForUser(const FString& UserName)
 	bSuccess = IFileManager::Get().DeleteDirectory(*UserSaveFile, true, true);
 	if (bSuccess)
 	{
+		//The index file and thumbnails were in the removed folder.
+		bSlotIndexLoaded = false;
+		ThumbnailCache.Empty();
+
 		UE_LOG(LogEasyMultiSave, Log, TEXT("Save Game User Data removed for: %s"), *UserName);
 	}
 }
@@ -533,40 +668,266 @@ USaveGame* UEMSObject::LoadObject(const FString& FullSavePath, TSubclassOf<USave
 Archive Functions
 **/
 
-static bool SaveBinaryData(const TArray<uint8>& SavedData, const FString& FullSavePath)
+static bool SaveBinaryData(const TArray<uint8>& SavedData, const FString& FullSavePath, const FString& AtomicFilePath)
 {
+	if (!AtomicFilePath.IsEmpty())
+	{
+		//Same file as the generic save game system, but written to a temp file first. 
+		const FString TempFilePath = AtomicFilePath + TEXT(".tmp");
+
+		if (!FFileHelper::SaveArrayToFile(SavedData, *TempFilePath))
+		{
+			return false;
+		}
+
+		return IFileManager::Get().Move(*AtomicFilePath, *TempFilePath, true, true, false, true);
+	}
+
 	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
 	return SaveSystem->SaveGame(false, *FullSavePath, PlayerIndex, SavedData);
 }
 
-bool UEMSObject::SaveBinaryArchive(FBufferArchive& BinaryData, const FString& FullSavePath)
+static FName GetCompressionFormatName(ESaveCompressionCodec& Codec)
 {
-	bool bSuccess = false;
-	const bool bNoCompression = IsConsoleFileSystem();
+	FName FormatName = NAME_None;
+
+	switch (Codec)
+	{
+		case ESaveCompressionCodec::SC_Zlib: FormatName = NAME_Zlib; break;
+		case ESaveCompressionCodec::SC_LZ4: FormatName = NAME_LZ4; break;
+		case ESaveCompressionCodec::SC_Oodle: FormatName = NAME_Oodle; break;
+		default: return NAME_None;
+	}
+
+	if (!FCompression::IsFormatValid(FormatName))
+	{
+		Codec = ESaveCompressionCodec::SC_Zlib;
+		return NAME_Zlib;
+	}
+
+	return FormatName;
+}
+
+static bool CompressBinaryData(const TArray<uint8>& BinaryData, ESaveCompressionCodec Codec, FSaveFileHeader& OutHeader, TArray<uint8>& OutData)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EMS_Compress);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_Compress);
+
+	const FName FormatName = GetCompressionFormatName(Codec);
+
+	OutHeader.Codec = uint8(Codec);
+	OutHeader.UncompressedSize = BinaryData.Num();
+	OutHeader.Checksum = FCrc::MemCrc32(BinaryData.GetData(), BinaryData.Num());
+
+	const int32 StartSize = OutData.Num();
 
-	if (bNoCompression)
+	if (FormatName.IsNone())
 	{
-		bSuccess = SaveBinaryData(BinaryData, FullSavePath);
+		OutData.Append(BinaryData);
+		return true;
+	}
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, BinaryData.Num());
+	OutData.AddUninitialized(CompressedSize);
+
+	if (!FCompression::CompressMemory(FormatName, OutData.GetData() + StartSize, CompressedSize, BinaryData.GetData(), BinaryData.Num()))
+	{
+		return false;
+	}
+
+	OutData.SetNum(StartSize + CompressedSize, false);
+	return true;
+}
+
+static bool UncompressBinaryData(const FSaveFileHeader& Header, const uint8* Payload, const int32& PayloadSize, TArray<uint8>& OutData, const FString& DebugName)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EMS_Decompress);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_Decompress);
+
+	ESaveCompressionCodec Codec = ESaveCompressionCodec(Header.Codec);
+	const FName FormatName = GetCompressionFormatName(Codec);
+
+	if (FormatName.IsNone())
+	{
+		OutData.Append(Payload, PayloadSize);
 	}
 	else
 	{
-		//Compress and save
-		TArray<uint8> CompressedData;
-		FArchiveSaveCompressedProxy Compressor = FArchiveSaveCompressedProxy(CompressedData, NAME_Zlib);
+		if (Header.UncompressedSize < 0 || Header.UncompressedSize > FMath::Min<int64>(SaveFileMaxUncompressedSize, MAX_int32))
+		{
+			UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot load, invalid uncompressed size %lld: %s"), Header.UncompressedSize, *DebugName);
+			return false;
+		}
+
+		OutData.SetNumUninitialized(int32(Header.UncompressedSize));
+
+		if (Codec != ESaveCompressionCodec(Header.Codec) 
+			|| !FCompression::UncompressMemory(FormatName, OutData.GetData(), OutData.Num(), Payload, PayloadSize))
+		{
+			UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot load, failed to decompress: %s"), *DebugName);
+			return false;
+		}
+	}
+
+	if (FCrc::MemCrc32(OutData.GetData(), OutData.Num()) != Header.Checksum)
+	{
+		UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot load, checksum mismatch: %s"), *DebugName);
+		return false;
+	}
+
+	return true;
+}
+
+static bool CompressAndSaveBinaryData(TArray<uint8>& BinaryData, const FString& FullSavePath, ESaveCompressionCodec Codec, const FString& AtomicFilePath, int64& OutCompressedBytes)
+{
+	//The header is written first and updated once the data is compressed.
+	FSaveFileHeader Header;
+
+	TArray<uint8> FileData;
+	FMemoryWriter HeaderWriter(FileData, true);
+	HeaderWriter << Header;
+
+	if (!CompressBinaryData(BinaryData, Codec, Header, FileData))
+	{
+		UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot save, compressor error: %s"), *FullSavePath);
+		return false;
+	}
+
+	HeaderWriter.Seek(0);
+	HeaderWriter << Header;
+
+	INC_DWORD_STAT_BY(STAT_EMS_UncompressedBytes, BinaryData.Num());
+	INC_DWORD_STAT_BY(STAT_EMS_CompressedBytes, FileData.Num());
+	OutCompressedBytes = FileData.Num();
+
+	UE_LOG(LogEasyMultiSave, Verbose, TEXT("Writing %s: %d bytes, %d bytes on disk"), *FullSavePath, BinaryData.Num(), FileData.Num());
+
+	return SaveBinaryData(FileData, FullSavePath, AtomicFilePath);
+}
+
+static bool DecompressBinaryData(TArray<uint8>& FileData, TArray<uint8>& OutData, const bool& bLegacyNoCompression, const FString& FullSavePath)
+{
+	FSaveFileHeader Header;
+	Header.Magic = 0;
+
+	FMemoryReader HeaderReader(FileData, true);
+	HeaderReader << Header;
+
+	//Files without header are either uncompressed (console) or Zlib compressed.
+	if (Header.Magic != SaveFileMagic)
+	{
+		if (bLegacyNoCompression)
+		{
+			OutData = MoveTemp(FileData);
+			return true;
+		}
+
+		FArchiveLoadCompressedProxy Decompressor = FArchiveLoadCompressedProxy(FileData, NAME_Zlib);
 
-		if (Compressor.GetError())
+		if (Decompressor.GetError())
 		{
-			UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot save, compressor error: %s"), *FullSavePath);
+			UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot load, file might not be compressed: %s"), *FullSavePath);
 			return false;
 		}
 
-		Compressor << BinaryData;
-		Compressor.Flush();
+		Decompressor << OutData;
+
+		Decompressor.FlushCache();
+		Decompressor.Close();
+
+		return true;
+	}
+
+	if (!Header.IsValid() || HeaderReader.IsError())
+	{
+		UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot load, unsupported file version %d: %s"), Header.Version, *FullSavePath);
+		return false;
+	}
+
+	const int64 HeaderSize = HeaderReader.Tell();
+	return UncompressBinaryData(Header, FileData.GetData() + HeaderSize, FileData.Num() - HeaderSize, OutData, FullSavePath);
+}
+
+static bool PackLevelChunk(FLevelArchive& LevelArchive, const ESaveCompressionCodec& Codec, FLevelChunk& OutChunk)
+{
+	FBufferArchive LevelData;
+	LevelData << LevelArchive;
+
+	OutChunk.Level = LevelArchive.Level;
+	OutChunk.Data.Reset();
 
-		bSuccess = SaveBinaryData(CompressedData, FullSavePath);
+	return CompressBinaryData(LevelData, Codec, OutChunk.Header, OutChunk.Data);
+}
 
-		Compressor.FlushCache();
-		Compressor.Close();
+static bool UnpackLevelChunk(const FLevelChunk& Chunk, FLevelArchive& OutArchive, const TSet<FName>* SkipActors = nullptr)
+{
+	TArray<uint8> LevelData;
+	if (!UncompressBinaryData(Chunk.Header, Chunk.Data.GetData(), Chunk.Data.Num(), LevelData, Chunk.Level.ToString()))
+	{
+		return false;
+	}
+
+	FMemoryReader FromBinary = FMemoryReader(LevelData, true);
+	OutArchive.Load(FromBinary, SkipActors);
+
+	return !FromBinary.IsError();
+}
+
+bool UEMSObject::SaveBinaryArchive(FBufferArchive& BinaryData, const FString& FullSavePath, const bool bCompress, TFunction<void()> OnWritten)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EMS_SaveBinaryArchive);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_SaveBinaryArchive);
+
+	bool bSuccess = false;
+	const ESaveCompressionCodec Codec = bCompress ? GetCompressionCodec() : ESaveCompressionCodec::SC_None;
+
+	//Console uses the platform save system, which is already responsible for safe writes.
+	const FString AtomicFilePath = IsConsoleFileSystem() ? FString() : SaveGameFilePath(FullSavePath);
+
+	OperationCounters.ArchiveBytes += BinaryData.Num();
+
+	if (UseAsyncFileWriting())
+	{
+		//A previous write to the same file must be done, otherwise the older data could end up on disk.
+		WaitForPendingWrite(FullSavePath);
+
+		//The snapshot is immutable from here on, compressing and writing is done on a worker thread.
+		TArray<uint8> Snapshot = MoveTemp(static_cast<TArray<uint8>&>(BinaryData));
+
+		//The written size is only returned, it is added to the counters by whoever waits for the write.
+		TFuture<int64> WriteTask = Async(EAsyncExecution::ThreadPool, [Snapshot = MoveTemp(Snapshot), FullSavePath, Codec, AtomicFilePath, OnWritten = MoveTemp(OnWritten)]() mutable
+		{
+			int64 CompressedBytes = 0;
+			const bool bWriteSuccess = CompressAndSaveBinaryData(Snapshot, FullSavePath, Codec, AtomicFilePath, CompressedBytes);
+			if (!bWriteSuccess)
+			{
+				UE_LOG(LogEasyMultiSave, Error, TEXT("Failed to write save file: %s"), *FullSavePath);
+			}
+			else if (OnWritten)
+			{
+				OnWritten();
+			}
+
+			return bWriteSuccess ? CompressedBytes : int64(INDEX_NONE);
+		});
+
+		{
+			FScopeLock Lock(&PendingWriteSection);
+			PendingWrites.Add(FullSavePath, MoveTemp(WriteTask));
+		}
+
+		bSuccess = true;
+	}
+	else
+	{
+		int64 CompressedBytes = 0;
+		bSuccess = CompressAndSaveBinaryData(BinaryData, FullSavePath, Codec, AtomicFilePath, CompressedBytes);
+		CompletePendingWrite(bSuccess ? CompressedBytes : int64(INDEX_NONE));
+
+		if (bSuccess && OnWritten)
+		{
+			OnWritten();
+		}
 	}
 
 	BinaryData.FlushCache();
@@ -576,8 +937,93 @@ bool UEMSObject::SaveBinaryArchive(FBufferArchive& BinaryData, const FString& Fu
 	return bSuccess;
 }
 
+bool UEMSObject::WaitForPendingWrite(const FString& FullSavePath)
+{
+	TFuture<int64> WriteTask;
+	{
+		FScopeLock Lock(&PendingWriteSection);
+		if (TFuture<int64>* PendingTask = PendingWrites.Find(FullSavePath))
+		{
+			WriteTask = MoveTemp(*PendingTask);
+			PendingWrites.Remove(FullSavePath);
+		}
+	}
+
+	return !WriteTask.IsValid() || CompletePendingWrite(WriteTask.Get());
+}
+
+void UEMSObject::WaitForPendingWrites()
+{
+	TMap<FString, TFuture<int64>> WriteTasks;
+	{
+		FScopeLock Lock(&PendingWriteSection);
+		WriteTasks = MoveTemp(PendingWrites);
+		PendingWrites.Reset();
+	}
+
+	for (auto It = WriteTasks.CreateIterator(); It; ++It)
+	{
+		CompletePendingWrite(It.Value().Get());
+	}
+}
+
+bool UEMSObject::CompletePendingWrite(const int64 WrittenBytes)
+{
+	if (WrittenBytes < 0)
+	{
+		FailedWrites.Increment();
+		return false;
+	}
+
+	//The counters are only touched on the game thread, loads may wait for writes on a worker.
+	if (IsInGameThread())
+	{
+		OperationCounters.CompressedBytes += WrittenBytes;
+	}
+	else
+	{
+		TWeakObjectPtr<UEMSObject> WeakThis(this);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, WrittenBytes]()
+		{
+			if (UEMSObject* EMS = WeakThis.Get())
+			{
+				EMS->OperationCounters.CompressedBytes += WrittenBytes;
+			}
+		});
+	}
+
+	return true;
+}
+
+bool UEMSObject::HasPendingWrites()
+{
+	FScopeLock Lock(&PendingWriteSection);
+
+	for (auto It = PendingWrites.CreateIterator(); It; ++It)
+	{
+		if (It.Value().IsReady())
+		{
+			CompletePendingWrite(It.Value().Get());
+			It.RemoveCurrent();
+		}
+	}
+
+	return PendingWrites.Num() > 0;
+}
+
 bool UEMSObject::LoadBinaryArchive(const EDataLoadType& LoadType, const FString& FullSavePath, UObject* Object)
 {
+	SCOPE_CYCLE_COUNTER(STAT_EMS_LoadBinaryArchive);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_LoadBinaryArchive);
+
+	WaitForPendingWrite(FullSavePath);
+
+	bool bMappedSuccess = false;
+	if (LoadMappedBinaryArchive(LoadType, FullSavePath, Object, bMappedSuccess))
+	{
+		return bMappedSuccess;
+	}
+
 	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
 	if (!SaveSystem->DoesSaveGameExist(*FullSavePath, PlayerIndex))
 	{
@@ -597,52 +1043,137 @@ bool UEMSObject::LoadBinaryArchive(const EDataLoadType& LoadType, const FString&
 		return false;
 	}
 
-	bool bSuccess = false;
-	const bool bNoCompression = IsConsoleFileSystem();
+	TArray<uint8> DecompressedBinary;
+	if (!DecompressBinaryData(BinaryData, DecompressedBinary, IsConsoleFileSystem(), FullSavePath))
+	{
+		return false;
+	}
 
-	if (bNoCompression)
+	BinaryData.Empty();
+
+	//Only needed to match the delta journal to the full archive.
+	if (LoadType == EDataLoadType::DATA_Level && (IsDeltaSave() || !ArrayEmpty(LevelDeltaJournal.Segments)))
 	{
-		FMemoryReader FromBinary = FMemoryReader(BinaryData, true);
-		FromBinary.Seek(0);
+		LoadedLevelChecksum = FCrc::MemCrc32(DecompressedBinary.GetData(), DecompressedBinary.Num());
+	}
+
+	FMemoryReader FromBinary = FMemoryReader(DecompressedBinary, true);
+	FromBinary.Seek(0);
 
-		bSuccess = UnpackBinaryArchive(LoadType, FromBinary, Object);
+	//Unpack archive 
+	const bool bSuccess = UnpackBinaryArchive(LoadType, FromBinary, Object);
 
-		FromBinary.FlushCache();
-		FromBinary.Close();
+	FromBinary.FlushCache();
+	FromBinary.Close();
+
+	return bSuccess;
+}
+
+bool UEMSObject::LoadMappedBinaryArchive(const EDataLoadType& LoadType, const FString& FullSavePath, UObject* Object, bool& bOutSuccess)
+{
+	//Console files can only be read through the platform save system.
+	if (IsConsoleFileSystem())
+	{
+		return false;
 	}
-	else
+
+	const FString FilePath = SaveGameFilePath(FullSavePath);
+
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() <= 0)
 	{
-		FArchiveLoadCompressedProxy Decompressor = FArchiveLoadCompressedProxy(BinaryData, NAME_Zlib);
+		return false;
+	}
 
-		if (Decompressor.GetError())
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion());
+	if (!MappedRegion.IsValid())
+	{
+		return false;
+	}
+
+	const uint8* MappedData = MappedRegion->GetMappedPtr();
+	const int64 MappedSize = MappedRegion->GetMappedSize();
+
+	FSaveFileHeader Header;
+	Header.Magic = 0;
+
+	FMemoryReaderView HeaderReader(TArrayView64<const uint8>(MappedData, MappedSize), true);
+	HeaderReader << Header;
+
+	//Files without header use the regular path.
+	if (Header.Magic != SaveFileMagic)
+	{
+		return false;
+	}
+
+	bOutSuccess = false;
+
+	if (!Header.IsValid() || HeaderReader.IsError())
+	{
+		UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot load, unsupported file version %d: %s"), Header.Version, *FullSavePath);
+		return true;
+	}
+
+	const int64 HeaderSize = HeaderReader.Tell();
+	if (MappedSize - HeaderSize > MAX_int32)
+	{
+		UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot load, file is too large (%lld bytes): %s"), MappedSize, *FullSavePath);
+		return true;
+	}
+
+	const uint8* Payload = MappedData + HeaderSize;
+	const int32 PayloadSize = int32(MappedSize - HeaderSize);
+
+	if (LoadType == EDataLoadType::DATA_Level)
+	{
+		LoadedLevelChecksum = Header.Checksum;
+	}
+
+	//Uncompressed data is read directly from the mapped file.
+	if (ESaveCompressionCodec(Header.Codec) == ESaveCompressionCodec::SC_None)
+	{
+		if (FCrc::MemCrc32(Payload, PayloadSize) != Header.Checksum)
 		{
-			UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot load, file might not be compressed: %s"), *FullSavePath);
-			return false;
+			UE_LOG(LogEasyMultiSave, Error, TEXT("Cannot load, checksum mismatch: %s"), *FullSavePath);
+			return true;
 		}
 
-		FBufferArchive DecompressedBinary;
-		Decompressor << DecompressedBinary;
+		FMemoryReaderView FromBinary(TArrayView64<const uint8>(Payload, PayloadSize), true);
+		bOutSuccess = UnpackBinaryArchive(LoadType, FromBinary, Object);
+		return true;
+	}
 
-		FMemoryReader FromBinary = FMemoryReader(DecompressedBinary, true);
-		FromBinary.Seek(0);
+	TArray<uint8> DecompressedBinary;
+	if (!UncompressBinaryData(Header, Payload, PayloadSize, DecompressedBinary, FullSavePath))
+	{
+		return true;
+	}
 
-		//Unpack archive 
-		bSuccess = UnpackBinaryArchive(LoadType, FromBinary, Object);
+	//Release the mapping, so only the decompressed data is kept while unpacking.
+	MappedRegion.Reset();
+	MappedFile.Reset();
 
-		Decompressor.FlushCache();
-		Decompressor.Close();
+	FMemoryReader FromBinary = FMemoryReader(DecompressedBinary, true);
+	bOutSuccess = UnpackBinaryArchive(LoadType, FromBinary, Object);
+	return true;
+}
 
-		DecompressedBinary.Empty();
-		DecompressedBinary.Close();
+TSet<FName> UEMSObject::GetLoadedActorNames() const
+{
+	TSet<FName> LoadedActors;
 
-		FromBinary.FlushCache();
-		FromBinary.Close();
+	for (const TPair<FName, AActor*>& NamedActor : ActorMap)
+	{
+		if (NamedActor.Value && NamedActor.Value->ActorHasTag(HasLoadedTag))
+		{
+			LoadedActors.Add(NamedActor.Key);
+		}
 	}
 
-	return bSuccess;
+	return LoadedActors;
 }
 
-bool UEMSObject::UnpackBinaryArchive(const EDataLoadType& LoadType, FMemoryReader FromBinary, UObject* Object)
+bool UEMSObject::UnpackBinaryArchive(const EDataLoadType& LoadType, FArchive& FromBinary, UObject* Object)
 {
 	if (LoadType == EDataLoadType::DATA_Level)
 	{
@@ -651,33 +1182,72 @@ bool UEMSObject::UnpackBinaryArchive(const EDataLoadType& LoadType, FMemoryReade
 		//Check for multi level saving.
 		if (IsNormalMultiLevelSave())
 		{
-			FLevelStackArchive LevelStack;
-			FromBinary << LevelStack;
+			FLevelChunkArchive ChunkStack;
+			FromBinary << ChunkStack;
 
-			//Copy from disk to memory.
-			if (ArrayEmpty(LevelArchiveList))
+			if (ChunkStack.Magic != LevelChunkMagic)
 			{
-				LevelArchiveList = LevelStack.Archives;
+				//Convert older saves, they are written as chunks on the next save.
+				FromBinary.Seek(0);
+
+				FLevelStackArchive LevelStack;
+				FromBinary << LevelStack;
+
+				ChunkStack = FLevelChunkArchive();
+				ChunkStack.SavedGameMode = LevelStack.SavedGameMode;
+				ChunkStack.SavedGameState = LevelStack.SavedGameState;
+
+				for (FLevelArchive& StackedArchive : LevelStack.Archives)
+				{
+					FLevelChunk LevelChunk;
+					if (PackLevelChunk(StackedArchive, GetCompressionCodec(), LevelChunk))
+					{
+						ChunkStack.Chunks.Add(MoveTemp(LevelChunk));
+					}
+				}
 			}
 
-			//It will only unpack the archive for the current level, unless using persistent/slow mode. 
-			for (const FLevelArchive& StackedArchive : LevelStack.Archives)
+			//Records of Actors that are already loaded are never deserialized.
+			const TSet<FName> LoadedActors = GetLoadedActorNames();
+
+			//It will only unpack the chunk for the current level, unless using persistent/slow mode. 
+			for (const FLevelChunk& LevelChunk : ChunkStack.Chunks)
 			{
-				if (StackedArchive.Level == GetLevelName() || IsSlowMultiLevelSave())
+				if (LevelChunk.Level == GetLevelName() || IsSlowMultiLevelSave())
 				{
-					UnpackLevel(StackedArchive);
+					FLevelArchive StackedArchive;
+					if (UnpackLevelChunk(LevelChunk, StackedArchive, &LoadedActors))
+					{
+						UnpackLevel(StackedArchive);
+					}
 				}
 			}
 
-			SavedGameMode = LevelStack.SavedGameMode;
-			SavedGameState = LevelStack.SavedGameState;
+			SavedGameMode = ChunkStack.SavedGameMode;
+			SavedGameState = ChunkStack.SavedGameState;
+
+			//Copy from disk to memory.
+			if (ArrayEmpty(LevelChunkStack.Chunks))
+			{
+				LevelChunkStack = MoveTemp(ChunkStack);
+			}
 
 			bLevelLoadSuccess = true;
 		}
 		else
 		{
 			FLevelArchive LevelArchive;
-			FromBinary << LevelArchive;
+
+			//Streaming and delta saves keep the full archive in memory, otherwise loaded Actors can be skipped.
+			if (IsStreamMultiLevelSave() || IsDeltaSave())
+			{
+				FromBinary << LevelArchive;
+			}
+			else
+			{
+				const TSet<FName> LoadedActors = GetLoadedActorNames();
+				LevelArchive.Load(FromBinary, &LoadedActors);
+			}
 
 			//Streaming Multi Level save specific.  
 			if (IsStreamMultiLevelSave())
@@ -685,6 +1255,11 @@ bool UEMSObject::UnpackBinaryArchive(const EDataLoadType& LoadType, FMemoryReade
 				//Copy from disk to memory.
 				MultiLevelStreamData.CopyFrom(LevelArchive);
 			}
+			else
+			{
+				//Changes from delta saves are stored in a journal next to the level file.
+				ApplyLevelDelta(LevelArchive);
+			}
 
 			if (UnpackLevel(LevelArchive))
 			{
@@ -731,6 +1306,14 @@ bool UEMSObject::UnpackBinaryArchive(const EDataLoadType& LoadType, FMemoryReade
 			}
 		}
 	}
+	else if (LoadType == EDataLoadType::DATA_Journal)
+	{
+		FLevelDeltaJournal Journal;
+		FromBinary << Journal;
+
+		LevelDeltaJournal = Journal;
+		return true;
+	}
 	else if (LoadType == EDataLoadType::DATA_Object)
 	{
 		if (Object)
@@ -772,24 +1355,25 @@ bool UEMSObject::UnpackPlayer(const FPlayerArchive& PlayerArchive)
 	return true;
 }
 
-bool UEMSObject::UnpackLevel(const FLevelArchive& LevelArchive)
+bool UEMSObject::UnpackLevel(FLevelArchive& LevelArchive)
 {
 	bool bLevelLoadSuccess = false;
 
 	ClearSavedLevelActors();
 
-	for (const FActorSaveData& TempSavedActor : LevelArchive.SavedActors)
+	//Records are moved, the archive is not used after unpacking.
+	for (FActorSaveData& TempSavedActor : LevelArchive.SavedActors)
 	{
 		if (EActorType(TempSavedActor.Type) == EActorType::AT_Persistent)
 		{
-			SavedActors.Add(TempSavedActor);
+			SavedActors.Add(MoveTemp(TempSavedActor));
 			bLevelLoadSuccess = true;
 		}
 		else
 		{
 			if (LevelArchive.Level == GetLevelName())
 			{
-				SavedActors.Add(TempSavedActor);
+				SavedActors.Add(MoveTemp(TempSavedActor));
 				bLevelLoadSuccess = true;
 			}
 		}
@@ -822,6 +1406,13 @@ bool UEMSObject::TryLoadPlayerFile()
 
 bool UEMSObject::TryLoadLevelFile()
 {
+	//The journal is only written without Multi-Level Saving, but may exist even if delta saving was disabled later.
+	if (UEMSPluginSettings::Get()->MultiLevelSaving == EMultiLevelSaveMethod::ML_Disabled)
+	{
+		LevelDeltaJournal = FLevelDeltaJournal();
+		LoadBinaryArchive(EDataLoadType::DATA_Journal, ActorJournalFile());
+	}
+
 	return LoadBinaryArchive(EDataLoadType::DATA_Level, ActorSaveFile());
 }
 
@@ -831,7 +1422,12 @@ Saving Game Actors General Functions
 
 void UEMSObject::PrepareLoadAndSaveActors(const uint32& Flags, const bool& bFullReload)
 {
+	SCOPE_CYCLE_COUNTER(STAT_EMS_PrepareActors);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_PrepareActors);
+
 	TArray<AActor*> Actors;
+	TMap<FName, AActor*> NamedActors;
+
 	for (FActorIterator It(GetWorld()); It; ++It)
 	{
 		AActor* Actor = *It;
@@ -872,12 +1468,22 @@ void UEMSObject::PrepareLoadAndSaveActors(const uint32& Flags, const bool& bFull
 			if (Type == EActorType::AT_Runtime || Type == EActorType::AT_Placed || Type == EActorType::AT_LevelScript || Type == EActorType::AT_Persistent)
 			{
 				Actors.Add(Actor);
+
+				//Name lookup for loading, so we don't compare each saved Actor against the whole list.
+				//The first Actor with a name is kept, same as the previous search through the list.
+				NamedActors.FindOrAdd(FName(*GetFullActorName(Actor)), Actor);
 			}
 		}
 	}
 
 	ActorList.Empty();
 	ActorList = Actors;
+
+	OperationCounters.Start();
+	OperationCounters.ActorsGathered = ActorList.Num();
+
+	ActorMap.Empty();
+	ActorMap = NamedActors;
 }
 
 /**
@@ -886,11 +1492,18 @@ Saving and Loading Level Actors
 
 void UEMSObject::SaveLevelActors()
 {
+	SCOPE_CYCLE_COUNTER(STAT_EMS_SaveLevelActors);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_SaveLevelActors);
+
 	TArray<FActorSaveData> InActors;
+	TArray<FName> InActorLevels;
 	TArray<FLevelScriptSaveData> InScripts;
 	FGameObjectSaveData InGameMode;
 	FGameObjectSaveData InGameState;
 
+	const bool bParallelSerialization = UEMSPluginSettings::Get()->bParallelSerialization;
+	TArray<AActor*> InActorObjects;
+
 	for (AActor* Actor : ActorList)
 	{
 		if (Actor && IsValidForSaving(Actor))
@@ -904,7 +1517,7 @@ void UEMSObject::SaveLevelActors()
 
 				if (Type == EActorType::AT_Runtime || Type == EActorType::AT_Persistent)
 				{
-					ActorArray.Class = BytesFromString(Actor->GetClass()->GetPathName());
+					ActorArray.Class = FName(*Actor->GetClass()->GetPathName());
 				}
 			
 				ActorArray.Type = uint8(Type);
@@ -919,10 +1532,21 @@ void UEMSObject::SaveLevelActors()
 					ActorArray.Transform = Actor->GetActorTransform();
 				}
 
-				ActorArray.Name = BytesFromString(GetFullActorName(Actor));
+				ActorArray.Name = FName(*GetFullActorName(Actor));
+
+				//Serialized in one batch after gathering
+				if (bParallelSerialization)
+				{
+					InActorObjects.Add(Actor);
+				}
+				else
+				{
+					SaveActorToBinary(Actor, ActorArray.SaveData);
+				}
 
-				SaveActorToBinary(Actor, ActorArray.SaveData);
 				InActors.Add(ActorArray);
+				InActorLevels.Add(LevelScriptSaveName(Actor));
+				OperationCounters.ActorsSaved++;
 			}
 			//Add Level Script Data
 			else if (Type == EActorType::AT_LevelScript)
@@ -935,6 +1559,11 @@ void UEMSObject::SaveLevelActors()
 			}
 		}
 	}
+
+	if (bParallelSerialization)
+	{
+		SaveActorsToBinaryParallel(InActorObjects, InActors);
+	}
 	
 	//Game Mode Actor
 	AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
@@ -954,8 +1583,8 @@ void UEMSObject::SaveLevelActors()
 
 	FLevelArchive LevelArchive;
 	{
-		LevelArchive.SavedActors = InActors;
-		LevelArchive.SavedScripts = InScripts;
+		LevelArchive.SavedActors = MoveTemp(InActors);
+		LevelArchive.SavedScripts = MoveTemp(InScripts);
 
 		if (!IsNormalMultiLevelSave())
 		{
@@ -966,82 +1595,257 @@ void UEMSObject::SaveLevelActors()
 		LevelArchive.Level = GetLevelName();
 	}
 
+	bool bCompressFile = true;
+	TFunction<void()> OnLevelWritten;
+
 	//Check for multi level saving.
 	if (IsNormalMultiLevelSave())
 	{
-		FLevelStackArchive LevelStack;
+		//Only the chunk of the current level is serialized and compressed, the others are kept from memory.
+		FLevelChunk LevelChunk;
+		if (!PackLevelChunk(LevelArchive, GetCompressionCodec(), LevelChunk))
+		{
+			UE_LOG(LogEasyMultiSave, Error, TEXT("Failed to compress Level Actors"));
+			return;
+		}
+
+		LevelChunkStack.ReplaceOrAdd(MoveTemp(LevelChunk));
+		LevelChunkStack.SavedGameMode = InGameMode;
+		LevelChunkStack.SavedGameState = InGameState;
+
+		LevelData << LevelChunkStack;
+
+		//Chunks are already compressed.
+		bCompressFile = false;
+	}
+	else if (IsStreamMultiLevelSave())
+	{
+		//Replace or add current Level Actors in memory, the records are moved and not copied.
+		MultiLevelStreamData.ReplaceOrAdd(MoveTemp(LevelArchive.SavedActors), InActorLevels, MoveTemp(LevelArchive.SavedScripts));
+
+		//Get Level and Game Mode etc. from LevelArchive.
+		MultiLevelStreamData.SerializeLevel(LevelData, LevelArchive);
+	}
+	else
+	{
+		//Delta saving only writes changed Actors, unless the journal needs to be compacted.
+		if (IsDeltaSave() && SaveLevelDelta(LevelArchive))
+		{
+			return;
+		}
+
+		LevelData << LevelArchive;
+
+		if (IsDeltaSave())
 		{
-			LevelStack.AddTo(LevelArchive);
-			LevelStack.SavedGameMode = InGameMode;
-			LevelStack.SavedGameState = InGameState;
+			LevelDeltaJournal.BaseChecksum = FCrc::MemCrc32(LevelData.GetData(), LevelData.Num());
 		}
 
-		//Add data from memory to the Stack Archive.
-		for (const FLevelArchive& MemoryArchive : LevelArchiveList)
+		//The journal of the previous archive is removed once the new one is on disk, until then the checksum keeps it from being applied.
+		WaitForPendingWrite(ActorJournalFile());
+
+		OnLevelWritten = [JournalFile = ActorJournalFile()]()
 		{
-			if (MemoryArchive != LevelArchive)
+			ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+			if (SaveSystem->DoesSaveGameExist(*JournalFile, PlayerIndex))
 			{
-				LevelStack.AddTo(MemoryArchive);
+				SaveSystem->DeleteGame(false, *JournalFile, PlayerIndex);
 			}
-		}
+		};
+	}
+
+	//Save and log
+	if (SaveBinaryArchive(LevelData, ActorSaveFile(), bCompressFile, MoveTemp(OnLevelWritten)))
+	{
+		UE_LOG(LogEasyMultiSave, Log, TEXT("Level and Game Actors have been saved"));
+	}
+	else
+	{
+		//The next delta save has no valid base, so it has to write a full archive.
+		bHasLevelDeltaBase = false;
+
+		UE_LOG(LogEasyMultiSave, Error, TEXT("Failed to save Level Actors"));
+	}
+}
+
+/**
+Delta Saving
+**/
+
+bool UEMSObject::SaveLevelDelta(const FLevelArchive& LevelArchive)
+{
+	TMap<FName, uint32> NewHashes;
+	NewHashes.Reserve(LevelArchive.SavedActors.Num());
+
+	for (const FActorSaveData& ActorArray : LevelArchive.SavedActors)
+	{
+		NewHashes.Add(GetActorSaveName(ActorArray), GetActorDataHash(ActorArray));
+	}
+
+	//Segments are only written on top of a full archive that reached the disk.
+	if (bHasLevelDeltaBase && !WaitForPendingWrite(ActorSaveFile()))
+	{
+		bHasLevelDeltaBase = false;
+	}
+
+	const int32 MaxSegments = FMath::Max(1, UEMSPluginSettings::Get()->DeltaCompactionInterval);
+	const bool bCompact = !bHasLevelDeltaBase 
+		|| LevelDeltaJournal.Level != LevelArchive.Level 
+		|| LevelDeltaJournal.Segments.Num() >= MaxSegments;
+
+	if (bCompact)
+	{
+		LevelDeltaJournal = FLevelDeltaJournal();
+		LevelDeltaJournal.Level = LevelArchive.Level;
+		LevelDeltaHashes = NewHashes;
+		bHasLevelDeltaBase = true;
 
-		//Update the list in memory with data from current level.
-		if (LevelArchiveList.Contains(LevelArchive))
+		return false;
+	}
+
+	FLevelDeltaSegment Segment;
+	{
+		for (const FActorSaveData& ActorArray : LevelArchive.SavedActors)
 		{
-			//If already in the array, we just replace the data.
-			for (FLevelArchive& ExistingArchive : LevelArchiveList)
+			const FName ActorName = GetActorSaveName(ActorArray);
+			const uint32* OldHash = LevelDeltaHashes.Find(ActorName);
+
+			if (!OldHash || *OldHash != NewHashes.FindChecked(ActorName))
 			{
-				if (ExistingArchive == LevelArchive)
-				{
-					ExistingArchive.ReplaceWith(LevelArchive);
-				}
+				Segment.ChangedActors.Add(ActorArray);
 			}
 		}
-		else
+
+		for (auto It = LevelDeltaHashes.CreateConstIterator(); It; ++It)
 		{
-			LevelArchiveList.Add(LevelArchive);
+			if (!NewHashes.Contains(It.Key()))
+			{
+				Segment.RemovedActors.Add(It.Key());
+			}
 		}
 
-		LevelData << LevelStack;
+		Segment.SavedScripts = LevelArchive.SavedScripts;
+		Segment.SavedGameMode = LevelArchive.SavedGameMode;
+		Segment.SavedGameState = LevelArchive.SavedGameState;
 	}
-	else if (IsStreamMultiLevelSave())
+
+	const int32 ChangedNum = Segment.ChangedActors.Num();
+	const int32 RemovedNum = Segment.RemovedActors.Num();
+
+	LevelDeltaJournal.Segments.Add(MoveTemp(Segment));
+
+	FBufferArchive JournalData;
+	JournalData << LevelDeltaJournal;
+
+	if (SaveBinaryArchive(JournalData, ActorJournalFile()))
 	{
-		//Get the data from memory and either replace or add current Level Actors.
-		FMultiLevelStreamingData NewStreamingData = MultiLevelStreamData;
+		LevelDeltaHashes = MoveTemp(NewHashes);
+
+		UE_LOG(LogEasyMultiSave, Log, TEXT("Level and Game Actors have been saved (Delta: %d changed, %d removed)"), ChangedNum, RemovedNum);
+	}
+	else
+	{
+		bHasLevelDeltaBase = false;
+
+		UE_LOG(LogEasyMultiSave, Error, TEXT("Failed to save Level Actor Delta"));
+	}
+
+	return true;
+}
+
+void UEMSObject::ApplyLevelDelta(FLevelArchive& LevelArchive)
+{
+	if (LevelDeltaJournal.Level == LevelArchive.Level && !ArrayEmpty(LevelDeltaJournal.Segments) && LevelDeltaJournal.BaseChecksum != LoadedLevelChecksum)
+	{
+		UE_LOG(LogEasyMultiSave, Warning, TEXT("Level Actor Delta was written for another save, it is ignored"));
+
+		LevelDeltaJournal = FLevelDeltaJournal();
+		LevelDeltaJournal.Level = LevelArchive.Level;
+	}
+
+	if (LevelDeltaJournal.Level == LevelArchive.Level && !ArrayEmpty(LevelDeltaJournal.Segments))
+	{
+		TMap<FName, int32> ActorIndices;
+		ActorIndices.Reserve(LevelArchive.SavedActors.Num());
+
+		for (int32 Index = 0; Index < LevelArchive.SavedActors.Num(); ++Index)
 		{
-			NewStreamingData.ReplaceOrAdd(LevelArchive);
+			ActorIndices.Add(GetActorSaveName(LevelArchive.SavedActors[Index]), Index);
 		}
 
-		//Get Level and Game Mode etc. from LevelArchive.
-		FLevelArchive NewLevelArchive = LevelArchive; 
+		TSet<FName> RemovedActors;
+
+		for (const FLevelDeltaSegment& Segment : LevelDeltaJournal.Segments)
 		{
-			NewLevelArchive.SavedActors = NewStreamingData.Actors;
-			NewLevelArchive.SavedScripts = NewStreamingData.Scripts;
+			for (const FActorSaveData& ActorArray : Segment.ChangedActors)
+			{
+				const FName ActorName = GetActorSaveName(ActorArray);
+				RemovedActors.Remove(ActorName);
+
+				if (const int32* Index = ActorIndices.Find(ActorName))
+				{
+					LevelArchive.SavedActors[*Index] = ActorArray;
+				}
+				else
+				{
+					ActorIndices.Add(ActorName, LevelArchive.SavedActors.Add(ActorArray));
+				}
+			}
+
+			RemovedActors.Append(Segment.RemovedActors);
 		}
 
-		//Update data in memory
-		MultiLevelStreamData.CopyFrom(NewLevelArchive);
+		if (RemovedActors.Num() > 0)
+		{
+			LevelArchive.SavedActors.RemoveAll([this, &RemovedActors](const FActorSaveData& ActorArray)
+			{
+				return RemovedActors.Contains(GetActorSaveName(ActorArray));
+			});
+		}
 
-		LevelData << NewLevelArchive;
+		//Scripts and game objects are fully stored in each segment.
+		const FLevelDeltaSegment& LastSegment = LevelDeltaJournal.Segments.Last();
+		LevelArchive.SavedScripts = LastSegment.SavedScripts;
+		LevelArchive.SavedGameMode = LastSegment.SavedGameMode;
+		LevelArchive.SavedGameState = LastSegment.SavedGameState;
 	}
 	else
 	{
-		LevelData << LevelArchive;
+		LevelDeltaJournal = FLevelDeltaJournal();
+		LevelDeltaJournal.Level = LevelArchive.Level;
 	}
 
-	//Save and log
-	if (SaveBinaryArchive(LevelData, ActorSaveFile()))
-	{
-		UE_LOG(LogEasyMultiSave, Log, TEXT("Level and Game Actors have been saved"));
-	}
-	else
+	//The loaded data is the base for the next delta save.
+	LevelDeltaJournal.BaseChecksum = LoadedLevelChecksum;
+	LevelDeltaHashes.Empty();
+	bHasLevelDeltaBase = false;
+
+	if (IsDeltaSave())
 	{
-		UE_LOG(LogEasyMultiSave, Error, TEXT("Failed to save Level Actors"));
+		LevelDeltaHashes.Reserve(LevelArchive.SavedActors.Num());
+		for (const FActorSaveData& ActorArray : LevelArchive.SavedActors)
+		{
+			LevelDeltaHashes.Add(GetActorSaveName(ActorArray), GetActorDataHash(ActorArray));
+		}
+
+		bHasLevelDeltaBase = true;
 	}
 }
 
+uint32 UEMSObject::GetActorDataHash(const FActorSaveData& ActorArray) const
+{
+	TArray<uint8> RecordData;
+	FMemoryWriter MemoryWriter(RecordData, true);
+	MemoryWriter << const_cast<FActorSaveData&>(ActorArray);
+
+	return FCrc::MemCrc32(RecordData.GetData(), RecordData.Num());
+}
+
 void UEMSObject::LoadLevelActors(UEMSAsyncLoadGame* LoadTask)
 {
+	SCOPE_CYCLE_COUNTER(STAT_EMS_LoadLevelActors);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_LoadLevelActors);
+
 	//Level Scripts
 	if (!ArrayEmpty(SavedScripts))
 	{
@@ -1106,6 +1910,8 @@ void UEMSObject::StartLoadLevelActors(UEMSAsyncLoadGame* LoadTask)
 		return;
 	}
 
+	LoadTimings = FActorLoadTimings();
+
 	//If authority, we use distance based loading
 	if (GetWorld()->GetNetMode() != ENetMode::NM_Client)
 	{
@@ -1127,6 +1933,9 @@ void UEMSObject::StartLoadLevelActors(UEMSAsyncLoadGame* LoadTask)
 	{
 		if (FPlatformProcess::SupportsMultithreading())
 		{
+			//Classes can only be loaded on the game thread, the worker just reads the cache.
+			PrepareSpawnClasses();
+
 			AsyncTask(ENamedThreads::AnyNormalThreadNormalTask, [this, LoadTask]()
 			{
 				LoadAllLevelActors(LoadTask);
@@ -1137,7 +1946,7 @@ void UEMSObject::StartLoadLevelActors(UEMSAsyncLoadGame* LoadTask)
 			LoadTask->StartDeferredLoad();
 		}
 	}
-	else if (UEMSPluginSettings::Get()->LoadMethod == ELoadMethod::LM_Deferred)
+	else if (UEMSPluginSettings::Get()->LoadMethod == ELoadMethod::LM_Deferred || UEMSPluginSettings::Get()->LoadMethod == ELoadMethod::LM_Budgeted)
 	{
 		LoadTask->StartDeferredLoad();
 	}
@@ -1201,43 +2010,51 @@ bool UEMSObject::SpawnOrUpdateLevelActor(const FActorSaveData& ActorArray)
 		SpawnLevelActor(ActorArray);
 	}
 
-	return UpdateResult != EUpdateActorResult::RES_Skip;
+	return UpdateResult != EUpdateActorResult::RES_Skip;
+}
+
+EUpdateActorResult UEMSObject::UpdateLevelActor(const FActorSaveData& ActorArray)
+{
+	//Update existing actors
+	AActor* Actor = FindActorForSaveData(ActorArray);
+	if (Actor && IsValidActor(Actor))
+	{
+		//Skips respawn
+		if (Actor->ActorHasTag(HasLoadedTag))
+		{
+			return EUpdateActorResult::RES_Skip;
+		}
+
+		if (!IsInGameThread())
+		{
+			AsyncTask(ENamedThreads::GameThread, [this, Actor, ActorArray]()
+			{
+				ProcessLevelActor(Actor, ActorArray);
+				return EUpdateActorResult::RES_Success;
+			});
+		}
+		else
+		{
+			ProcessLevelActor(Actor, ActorArray);
+		}
+
+		OperationCounters.ActorsUpdated++;
+		return EUpdateActorResult::RES_Success;
+	}
+
+	return EUpdateActorResult::RES_ShouldSpawnNewActor;
 }
 
-EUpdateActorResult UEMSObject::UpdateLevelActor(const FActorSaveData& ActorArray)
+AActor* UEMSObject::FindActorForSaveData(const FActorSaveData& ActorArray) const
 {
-	for (AActor* Actor : ActorList)
+	//The map is only read here, so this is also safe for Multi-Thread loading.
+	AActor* const* FoundActor = ActorMap.Find(GetActorSaveName(ActorArray));
+	if (FoundActor)
 	{
-		if (Actor && IsValidActor(Actor))
-		{
-			//Update existing actors
-			if (ActorArray.Name == BytesFromString(GetFullActorName(Actor)))
-			{
-				//Skips respawn
-				if (Actor->ActorHasTag(HasLoadedTag))
-				{
-					return EUpdateActorResult::RES_Skip;
-				}
-
-				if (!IsInGameThread())
-				{
-					AsyncTask(ENamedThreads::GameThread, [this, Actor, ActorArray]()
-					{
-						ProcessLevelActor(Actor, ActorArray);
-						return EUpdateActorResult::RES_Success;
-					});
-				}
-				else
-				{
-					ProcessLevelActor(Actor, ActorArray);
-				}
-
-				return EUpdateActorResult::RES_Success;
-			}	
-		}
+		return *FoundActor;
 	}
 
-	return EUpdateActorResult::RES_ShouldSpawnNewActor;
+	return nullptr;
 }
 
 bool UEMSObject::CheckForExistingActor(const FActorSaveData& ActorArray)
@@ -1250,7 +2067,7 @@ bool UEMSObject::CheckForExistingActor(const FActorSaveData& ActorArray)
 	const UWorld* ThisWorld = GetWorld();
 	if (ThisWorld && ThisWorld->PersistentLevel)
 	{
-		const FName LoadedActorName(*StringFromBytes(ActorArray.Name));
+		const FName LoadedActorName = GetActorSaveName(ActorArray);
 		AActor* NewLevelActor = Cast<AActor>(StaticFindObjectFast(nullptr, GetWorld()->PersistentLevel, LoadedActorName));
 		if (NewLevelActor)
 		{
@@ -1265,25 +2082,69 @@ bool UEMSObject::CheckForExistingActor(const FActorSaveData& ActorArray)
 	return false;
 }
 
-void UEMSObject::SpawnLevelActor(const FActorSaveData & ActorArray)
+void UEMSObject::PrepareSpawnClasses()
+{
+	check(IsInGameThread());
+
+	for (const FActorSaveData& ActorArray : SavedActors)
+	{
+		if (!ActorArray.Class.IsNone())
+		{
+			GetSpawnClass(ActorArray.Class);
+		}
+	}
+}
+
+UClass* UEMSObject::GetSpawnClass(const FName& ClassPath)
 {
-	const FString Class = StringFromBytes(ActorArray.Class);
-	if (Class.IsEmpty())
+	if (const TWeakObjectPtr<UClass>* CachedClass = SpawnClasses.Find(ClassPath))
 	{
-		return;
+		if (CachedClass->IsValid())
+		{
+			return CachedClass->Get();
+		}
+	}
+
+	//Multi-Thread loading only uses the classes from PrepareSpawnClasses.
+	if (!IsInGameThread())
+	{
+		UE_LOG(LogEasyMultiSave, Warning, TEXT("Spawn class was not prepared for Multi-Thread loading: %s"), *ClassPath.ToString());
+		return nullptr;
 	}
 
+	const FString Class = ClassPath.ToString();
+
 	UClass* SpawnClass = FindObject<UClass>(ANY_PACKAGE, *Class);
 	if (!SpawnClass)
 	{
 		SpawnClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *Class, nullptr, LOAD_None, nullptr));
 	}
 
+	if (SpawnClass)
+	{
+		SpawnClasses.Add(ClassPath, SpawnClass);
+	}
+
+	return SpawnClass;
+}
+
+void UEMSObject::SpawnLevelActor(const FActorSaveData & ActorArray)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EMS_SpawnLevelActor);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_SpawnLevelActor);
+
+	if (ActorArray.Class.IsNone())
+	{
+		return;
+	}
+
+	UClass* SpawnClass = GetSpawnClass(ActorArray.Class);
+
 	if (SpawnClass && SpawnClass->ImplementsInterface(UEMSActorSaveInterface::StaticClass()))
 	{
 		FActorSpawnParameters SpawnParams;
 		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnParams.Name = FName(*StringFromBytes(ActorArray.Name));
+		SpawnParams.Name = ActorArray.Name;
 		SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested; 
 
 		if (!IsInGameThread())
@@ -1304,7 +2165,13 @@ void UEMSObject::SpawnLevelActor(const FActorSaveData & ActorArray)
 		{
 			if (!CheckForExistingActor(ActorArray))
 			{
+				const double StartTime = FPlatformTime::Seconds();
 				AActor* NewActor = GetWorld()->SpawnActor(SpawnClass, &ActorArray.Transform, SpawnParams);
+
+				LoadTimings.SpawnTime += FPlatformTime::Seconds() - StartTime;
+				LoadTimings.SpawnNum++;
+				OperationCounters.ActorsSpawned++;
+
 				if (NewActor)
 				{
 					ProcessLevelActor(NewActor, ActorArray);
@@ -1319,18 +2186,32 @@ void UEMSObject::ProcessLevelActor(AActor* Actor, const FActorSaveData& ActorArr
 	//Only process matching type
 	if (EActorType(ActorArray.Type) == GetActorType(Actor))
 	{
+		const double StartTime = FPlatformTime::Seconds();
+
 		if (IsMovable(Actor->GetRootComponent()) && ActorArray.Transform.IsValid() && Actor->GetAttachParentActor() == nullptr)
 		{
 			Actor->SetActorTransform(ActorArray.Transform, false, nullptr, ETeleportType::TeleportPhysics);
 		}
 
 		LoadActorFromBinary(Actor, ActorArray.SaveData);
+
+		LoadTimings.DeserializeTime += FPlatformTime::Seconds() - StartTime;
+		LoadTimings.DeserializeNum++;
 	}
 }
 
+void UEMSObject::LogOperationCounters(const FString& OperationName) const
+{
+	UE_LOG(LogEasyMultiSave, Verbose, TEXT("%s finished in %llu frames: %d Actors gathered, %d saved, %d spawned, %d updated, %lld archive bytes, %lld compressed bytes"),
+		*OperationName, OperationCounters.GetFrameSpan(), OperationCounters.ActorsGathered, OperationCounters.ActorsSaved,
+		OperationCounters.ActorsSpawned, OperationCounters.ActorsUpdated, OperationCounters.ArchiveBytes, OperationCounters.CompressedBytes);
+}
+
 void UEMSObject::LogFinishLoadingLevel()
 {
 	UE_LOG(LogEasyMultiSave, Log, TEXT("Level Actors loaded"));
+	UE_LOG(LogEasyMultiSave, Verbose, TEXT("Spawned %d Actors in %.2f ms, deserialized %d Actors in %.2f ms"), 
+		LoadTimings.SpawnNum, LoadTimings.SpawnTime * 1000.0, LoadTimings.DeserializeNum, LoadTimings.DeserializeTime * 1000.0);
 
 	ClearSavedLevelActors();
 }
@@ -1341,6 +2222,9 @@ Saving and Loading Player
 
 void UEMSObject::SavePlayerActors()
 {
+	SCOPE_CYCLE_COUNTER(STAT_EMS_SavePlayerActors);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_SavePlayerActors);
+
 	bool bPlayerSaveSuccess = false;
 
 	//Controller
@@ -1422,6 +2306,9 @@ void UEMSObject::SavePlayerActors()
 
 void UEMSObject::LoadPlayerActors(UEMSAsyncLoadGame* LoadTask)
 {
+	SCOPE_CYCLE_COUNTER(STAT_EMS_LoadPlayerActors);
+	TRACE_CPUPROFILER_EVENT_SCOPE(EMS_LoadPlayerActors);
+
 	//Controller
 	APlayerController* Controller = GetPlayerController();
 	if (Controller && IsValidForLoading(Controller))
@@ -1474,6 +2361,22 @@ Loading and Saving Components
 
 void UEMSObject::SaveActorComponents(AActor* Actor, TArray<FComponentSaveData>& OutComponents)
 {
+	TArray<UObject*> SerializeObjects;
+	GatherActorComponents(Actor, OutComponents, SerializeObjects);
+
+	const int32 FirstComponent = OutComponents.Num() - SerializeObjects.Num();
+	for (int32 Index = 0; Index < SerializeObjects.Num(); Index++)
+	{
+		if (SerializeObjects[Index])
+		{
+			SerializeToBinary(SerializeObjects[Index], OutComponents[FirstComponent + Index].Data);
+		}
+	}
+}
+
+void UEMSObject::GatherActorComponents(AActor* Actor, TArray<FComponentSaveData>& OutComponents, TArray<UObject*>& OutObjects)
+{
+	//Adds one entry to OutObjects per added component, nullptr if it has no data to serialize
 	TArray<UActorComponent*> SourceComps;
 	IEMSActorSaveInterface::Execute_ComponentsToSave(Actor, SourceComps);
 
@@ -1495,6 +2398,8 @@ void UEMSObject::SaveActorComponents(AActor* Actor, TArray<FComponentSaveData>&
 				ComponentArray.RelativeTransform = SceneComp->GetRelativeTransform();
 			}
 
+			UObject* SerializeObject = nullptr;
+
 			const UChildActorComponent* ChildActorComp = Cast<UChildActorComponent>(Component);
 			if (ChildActorComp)
 			{
@@ -1503,7 +2408,7 @@ void UEMSObject::SaveActorComponents(AActor* Actor, TArray<FComponentSaveData>&
 				{
 					if (!HasSaveInterface(ChildActor))
 					{
-						SerializeToBinary(ChildActor, ComponentArray.Data);
+						SerializeObject = ChildActor;
 					}
 					else
 					{
@@ -1513,10 +2418,11 @@ void UEMSObject::SaveActorComponents(AActor* Actor, TArray<FComponentSaveData>&
 			}
 			else
 			{
-				SerializeToBinary(Component, ComponentArray.Data);
+				SerializeObject = Component;
 			}
 
 			OutComponents.Add(ComponentArray);
+			OutObjects.Add(SerializeObject);
 		}
 	}
 }
@@ -1590,6 +2496,52 @@ void UEMSObject::SaveActorToBinary(AActor* Actor, FGameObjectSaveData& OutData)
 	IEMSActorSaveInterface::Execute_ActorSaved(Actor);
 }
 
+void UEMSObject::SaveActorsToBinaryParallel(const TArray<AActor*>& Actors, TArray<FActorSaveData>& OutActors)
+{
+	check(Actors.Num() == OutActors.Num());
+
+	//Interface events and component lists are gathered in order on this thread
+	TArray<TArray<UObject*>> ComponentObjects;
+	ComponentObjects.SetNum(Actors.Num());
+
+	for (int32 Index = 0; Index < Actors.Num(); Index++)
+	{
+		AActor* Actor = Actors[Index];
+		IEMSActorSaveInterface::Execute_ActorPreSave(Actor);
+		Actor->Tags.Remove(HasLoadedTag);
+		GatherActorComponents(Actor, OutActors[Index].SaveData.Components, ComponentObjects[Index]);
+	}
+
+	//All records exist now, so the buffer pointers stay valid
+	TArray<TPair<UObject*, TArray<uint8>*>> SerializeJobs;
+	for (int32 Index = 0; Index < Actors.Num(); Index++)
+	{
+		FGameObjectSaveData& SaveData = OutActors[Index].SaveData;
+		SerializeJobs.Add(TPair<UObject*, TArray<uint8>*>(Actors[Index], &SaveData.Data));
+
+		const TArray<UObject*>& Objects = ComponentObjects[Index];
+		const int32 FirstComponent = SaveData.Components.Num() - Objects.Num();
+		for (int32 CompIndex = 0; CompIndex < Objects.Num(); CompIndex++)
+		{
+			if (Objects[CompIndex])
+			{
+				SerializeJobs.Add(TPair<UObject*, TArray<uint8>*>(Objects[CompIndex], &SaveData.Components[FirstComponent + CompIndex].Data));
+			}
+		}
+	}
+
+	//Each job writes to its own buffer, the record order is unchanged
+	ParallelFor(SerializeJobs.Num(), [this, &SerializeJobs](int32 Index)
+	{
+		SerializeToBinary(SerializeJobs[Index].Key, *SerializeJobs[Index].Value);
+	});
+
+	for (AActor* Actor : Actors)
+	{
+		IEMSActorSaveInterface::Execute_ActorSaved(Actor);
+	}
+}
+
 void UEMSObject::LoadActorFromBinary(AActor* Actor, const FGameObjectSaveData& InData)
 {
 	Actor->Tags.Add(HasLoadedTag);
@@ -1650,34 +2602,44 @@ void UEMSObject::SerializeActorStructProperties(AActor* Actor)
 
 void UEMSObject::SerializeStructProperties(UObject* Object)
 {
-	//Non-array struct vars.
-	for (TFieldIterator<FStructProperty> ObjectStruct(Object->GetClass()); ObjectStruct; ++ObjectStruct)
+	//Flags persist on the reflection data, so each class only needs to be walked once
+	if (!MarkStructPrepared(Object->GetClass()))
 	{
-		if (ObjectStruct && ObjectStruct->GetPropertyFlags() & CPF_SaveGame)
-		{
-			SerializeScriptStruct(ObjectStruct->Struct);
-		}
+		return;
 	}
 
-	//Struct-Arrays are cast as Arrays, not structs, so we work around it.
-	for (TFieldIterator<FArrayProperty> ArrayProp(Object->GetClass()); ArrayProp; ++ArrayProp)
+	for (TFieldIterator<FProperty> Prop(Object->GetClass()); Prop; ++Prop)
 	{
-		if (ArrayProp && ArrayProp->GetPropertyFlags() & CPF_SaveGame)
+		if (!Prop || !(Prop->GetPropertyFlags() & CPF_SaveGame))
 		{
-			SerializeArrayStruct(*ArrayProp);
+			continue;
 		}
-	}
 
-	//Map Properties
-	for (TFieldIterator<FMapProperty> MapProp(Object->GetClass()); MapProp; ++MapProp)
-	{
-		if (MapProp && MapProp->GetPropertyFlags() & CPF_SaveGame)
+		//Non-array struct vars.
+		if (FStructProperty* StructProp = CastField<FStructProperty>(*Prop))
+		{
+			SerializeScriptStruct(StructProp->Struct);
+		}
+		//Struct-Arrays are cast as Arrays, not structs, so we work around it.
+		else if (FArrayProperty* ArrayProp = CastField<FArrayProperty>(*Prop))
+		{
+			SerializeArrayStruct(ArrayProp);
+		}
+		//Map Properties
+		else if (FMapProperty* MapProp = CastField<FMapProperty>(*Prop))
 		{
-			SerializeMap(*MapProp);
+			SerializeMap(MapProp);
 		}
 	}
 }
 
+bool UEMSObject::MarkStructPrepared(const UStruct* Struct)
+{
+	bool bAlreadyPrepared = false;
+	PreparedStructs.Add(Struct, &bAlreadyPrepared);
+	return !bAlreadyPrepared;
+}
+
 void UEMSObject::SerializeMap(FMapProperty* MapProp)
 {
 	FProperty* ValueProp = MapProp->ValueProp;
@@ -1710,7 +2672,8 @@ void UEMSObject::SerializeArrayStruct(FArrayProperty* ArrayProp)
 
 void UEMSObject::SerializeScriptStruct(UStruct* ScriptStruct)
 {
-	if (ScriptStruct)
+	//Shared and self-referencing structs are only walked once
+	if (ScriptStruct && MarkStructPrepared(ScriptStruct))
 	{
 		for (TFieldIterator<FProperty> Prop(ScriptStruct); Prop; ++Prop)
 		{
@@ -1859,9 +2822,9 @@ FTimerManager& UEMSObject::GetTimerManager() const
 }
 
 template<class T>
-static bool CheckLoadIterator(const T& It, const ESaveGameMode& Mode, const bool& bLog, const FString& DebugString)
+static bool CheckActiveTask(const T* Task, const ESaveGameMode& Mode, const bool& bLog, const FString& DebugString)
 {
-	if (IsValid(*It) && It->bIsActive && (It->Mode == Mode || Mode == ESaveGameMode::MODE_All))
+	if (IsValid(Task) && Task->bIsActive && (Task->Mode == Mode || Mode == ESaveGameMode::MODE_All))
 	{
 		if (bLog)
 		{
@@ -1888,23 +2851,72 @@ bool UEMSObject::IsAsyncSaveOrLoadTaskActive(const ESaveGameMode& Mode, const EA
 
 	if (CheckType == EAsyncCheckType::CT_Both || CheckType == EAsyncCheckType::CT_Load)
 	{
-		for (TObjectIterator<UEMSAsyncLoadGame> It; It; ++It)
+		for (const UEMSAsyncLoadGame* LoadTask : LoadTasks)
 		{
-			return CheckLoadIterator(It, Mode, bLog, "Load Game Actors");
+			if (CheckActiveTask(LoadTask, Mode, bLog, "Load Game Actors"))
+			{
+				return true;
+			}
 		}
 	}
 
 	if (CheckType == EAsyncCheckType::CT_Both || CheckType == EAsyncCheckType::CT_Save)
 	{
-		for (TObjectIterator<UEMSAsyncSaveGame> It; It; ++It)
+		for (const UEMSAsyncSaveGame* SaveTask : SaveTasks)
 		{
-			return CheckLoadIterator(It, Mode, bLog, "Save Game Actors");
+			if (CheckActiveTask(SaveTask, Mode, bLog, "Save Game Actors"))
+			{
+				return true;
+			}
 		}
 	}
 
 	return false;
 }
 
+void UEMSObject::RegisterSaveTask(UEMSAsyncSaveGame* SaveTask)
+{
+	if (ArrayEmpty(SaveTasks))
+	{
+		SaveTasks.Add(SaveTask);
+		return;
+	}
+
+	//Only one save is queued, later requests are merged into it.
+	if (SaveTasks.Num() > 1)
+	{
+		SaveTasks.Last()->MergeTask(SaveTask);
+		return;
+	}
+
+	SaveTask->bIsQueued = true;
+	SaveTasks.Add(SaveTask);
+}
+
+void UEMSObject::UnregisterSaveTask(UEMSAsyncSaveGame* SaveTask)
+{
+	SaveTasks.Remove(SaveTask);
+
+	//Start the queued save, it has to be a tick later.
+	if (!ArrayEmpty(SaveTasks) && SaveTasks[0]->bIsQueued)
+	{
+		UEMSAsyncSaveGame* NextTask = SaveTasks[0];
+		NextTask->bIsQueued = false;
+
+		GetTimerManager().SetTimerForNextTick(NextTask, &UEMSAsyncSaveGame::StartSaveTask);
+	}
+}
+
+void UEMSObject::RegisterLoadTask(UEMSAsyncLoadGame* LoadTask)
+{
+	LoadTasks.AddUnique(LoadTask);
+}
+
+void UEMSObject::UnregisterLoadTask(UEMSAsyncLoadGame* LoadTask)
+{
+	LoadTasks.Remove(LoadTask);
+}
+
 bool UEMSObject::HasValidGameMode() const
 {
 	//On clients, we assume the game mode is valid
@@ -1985,19 +2997,164 @@ TSaveGame* UEMSObject::GetDesiredSaveObject(const FString& FullSavePath, const F
 /**
 Thumbnail Saving
 Simple saving as .png from a 2d scene capture render target source.
+Reading back, encoding and decoding is done off the game thread. Imported thumbnails are cached.
 **/
 
+static IImageWrapperModule& GetImageWrapperModule()
+{
+	//Must be loaded on the game thread before it is used by workers.
+	return FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+}
+
+static bool DecodeThumbnailFile(IImageWrapperModule& ImageWrapperModule, const FString& FilePath, TArray<uint8>& OutPixels, int32& OutWidth, int32& OutHeight)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *FilePath))
+	{
+		return false;
+	}
+
+	const EImageFormat Format = ImageWrapperModule.DetectImageFormat(FileData.GetData(), FileData.Num());
+	if (Format == EImageFormat::Invalid)
+	{
+		return false;
+	}
+
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(Format);
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(FileData.GetData(), FileData.Num()))
+	{
+		return false;
+	}
+
+	OutWidth = ImageWrapper->GetWidth();
+	OutHeight = ImageWrapper->GetHeight();
+
+	return ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, OutPixels);
+}
+
+static bool EncodeThumbnailFile(IImageWrapperModule& ImageWrapperModule, const TArray<FColor>& Pixels, const FIntPoint& Size, const FString& FilePath)
+{
+	if (Pixels.Num() != Size.X * Size.Y)
+	{
+		return false;
+	}
+
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(Pixels.GetData(), Pixels.Num() * sizeof(FColor), Size.X, Size.Y, ERGBFormat::BGRA, 8))
+	{
+		return false;
+	}
+
+	const TArray64<uint8> PNGData = ImageWrapper->GetCompressed(100);
+
+	//Written to a temp file first, so an import never reads a partial image.
+	const FString TempFilePath = FilePath + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(PNGData, *TempFilePath))
+	{
+		return false;
+	}
+
+	return IFileManager::Get().Move(*FilePath, *TempFilePath, true, true, false, true);
+}
+
+static UTexture2D* CreateThumbnailTexture(const TArray<uint8>& Pixels, const int32& Width, const int32& Height)
+{
+	if (Width <= 0 || Height <= 0 || Pixels.Num() != Width * Height * 4)
+	{
+		return nullptr;
+	}
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, PF_B8G8R8A8);
+	if (!Texture)
+	{
+		return nullptr;
+	}
+
+#if ENGINE_MAJOR_VERSION == 4
+	FTexture2DMipMap& Mip = Texture->PlatformData->Mips[0];
+#else
+	FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+#endif
+
+	void* TextureData = Mip.BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(TextureData, Pixels.GetData(), Pixels.Num());
+	Mip.BulkData.Unlock();
+
+	Texture->UpdateResource();
+
+	return Texture;
+}
+
 UTexture2D* UEMSObject::ImportSaveThumbnail(const FString& SaveGameName)
 {
 	const FString SaveThumbnailName = ThumbnailSaveFile(SaveGameName);
+	WaitForPendingWrite(SaveThumbnailName);
 
 	//Suppress warning messages when we dont have a thumb yet.
-	if (FPaths::FileExists(SaveThumbnailName))
+	const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*SaveThumbnailName);
+	if (TimeStamp == FDateTime::MinValue())
 	{
-		return FImageUtils::ImportFileAsTexture2D(SaveThumbnailName);
+		return nullptr;
 	}
-	
-	return nullptr;
+
+	if (UTexture2D* CachedTexture = FindCachedThumbnail(SaveThumbnailName, TimeStamp))
+	{
+		return CachedTexture;
+	}
+
+	UTexture2D* Texture = FImageUtils::ImportFileAsTexture2D(SaveThumbnailName);
+	AddCachedThumbnail(SaveThumbnailName, TimeStamp, Texture);
+
+	return Texture;
+}
+
+void UEMSObject::ImportSaveThumbnailAsync(const FString& SaveGameName, TFunction<void(UTexture2D*)>&& OnImported)
+{
+	const FString SaveThumbnailName = ThumbnailSaveFile(SaveGameName);
+	WaitForPendingWrite(SaveThumbnailName);
+
+	const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*SaveThumbnailName);
+	if (TimeStamp == FDateTime::MinValue())
+	{
+		OnImported(nullptr);
+		return;
+	}
+
+	if (UTexture2D* CachedTexture = FindCachedThumbnail(SaveThumbnailName, TimeStamp))
+	{
+		OnImported(CachedTexture);
+		return;
+	}
+
+	IImageWrapperModule* ImageWrapperModule = &GetImageWrapperModule();
+	TWeakObjectPtr<UEMSObject> WeakThis(this);
+
+	//The file is read and decoded on a worker, only the texture is created on the game thread.
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis, ImageWrapperModule, SaveThumbnailName, TimeStamp, OnImported = MoveTemp(OnImported)]() mutable
+	{
+		TArray<uint8> Pixels;
+		int32 Width = 0;
+		int32 Height = 0;
+
+		const bool bDecoded = DecodeThumbnailFile(*ImageWrapperModule, SaveThumbnailName, Pixels, Width, Height);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SaveThumbnailName, TimeStamp, bDecoded, Pixels = MoveTemp(Pixels), Width, Height, OnImported = MoveTemp(OnImported)]()
+		{
+			UTexture2D* Texture = nullptr;
+
+			if (bDecoded && WeakThis.IsValid())
+			{
+				Texture = CreateThumbnailTexture(Pixels, Width, Height);
+				WeakThis->AddCachedThumbnail(SaveThumbnailName, TimeStamp, Texture);
+			}
+			else
+			{
+				UE_LOG(LogEasyMultiSave, Warning, TEXT("ImportSaveThumbnail: Could not decode %s"), *SaveThumbnailName);
+			}
+
+			OnImported(Texture);
+		});
+	});
 }
 
 static bool HasRenderTargetResource(UTextureRenderTarget2D* TextureRenderTarget)
@@ -2024,6 +3181,10 @@ void UEMSObject::ExportSaveThumbnail(UTextureRenderTarget2D* TextureRenderTarget
 	{
 		UE_LOG(LogEasyMultiSave, Warning, TEXT("ExportSaveThumbnailRT: Render target has been released"));
 	}
+	else if (TextureRenderTarget->GetFormat() != PF_B8G8R8A8)
+	{
+		UE_LOG(LogEasyMultiSave, Warning, TEXT("ExportSaveThumbnailRT: Render target format must be RTF RGBA8"));
+	}
 	else if (!PathError.IsEmpty())
 	{
 		UE_LOG(LogEasyMultiSave, Warning, TEXT("ExportSaveThumbnailRT: Invalid file path provided: %s"), *PathError.ToString());
@@ -2034,26 +3195,89 @@ void UEMSObject::ExportSaveThumbnail(UTextureRenderTarget2D* TextureRenderTarget
 	}
 	else
 	{
-		FArchive* Ar = IFileManager::Get().CreateFileWriter(*SaveThumbnailName);
+		//A previous export of the same thumbnail must be done first.
+		WaitForPendingWrite(SaveThumbnailName);
+		ThumbnailCache.Remove(SaveThumbnailName);
+
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(SaveThumbnailName), true);
+
+		IImageWrapperModule* ImageWrapperModule = &GetImageWrapperModule();
+		FTextureRenderTargetResource* RenderTargetResource = TextureRenderTarget->GameThread_GetRenderTargetResource();
+
+		//Imports of this thumbnail wait for the promise.
+		TSharedRef<TPromise<int64>, ESPMode::ThreadSafe> WritePromise = MakeShared<TPromise<int64>, ESPMode::ThreadSafe>();
+		{
+			FScopeLock Lock(&PendingWriteSection);
+			PendingWrites.Add(SaveThumbnailName, WritePromise->GetFuture());
+		}
 
-		if (Ar)
+		//Pixels are read back on the render thread, so the game thread does not wait for the GPU.
+		ENQUEUE_RENDER_COMMAND(EMSReadThumbnail)([RenderTargetResource, ImageWrapperModule, SaveThumbnailName, WritePromise](FRHICommandListImmediate& RHICmdList)
 		{
-			FBufferArchive Buffer;
+			const FIntPoint Size = RenderTargetResource->GetSizeXY();
 
-			bool bSuccess = FImageUtils::ExportRenderTarget2DAsPNG(TextureRenderTarget, Buffer);
+			TArray<FColor> Pixels;
+			RHICmdList.ReadSurfaceData(RenderTargetResource->GetRenderTargetTexture(), FIntRect(FIntPoint::ZeroValue, Size), Pixels, FReadSurfaceDataFlags(RCM_UNorm));
 
-			if (bSuccess)
+			AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [ImageWrapperModule, SaveThumbnailName, WritePromise, Pixels = MoveTemp(Pixels), Size]()
 			{
-				Ar->Serialize(const_cast<uint8*>(Buffer.GetData()), Buffer.Num());
-			}
+				const bool bSuccess = EncodeThumbnailFile(*ImageWrapperModule, Pixels, Size, SaveThumbnailName);
+				if (!bSuccess)
+				{
+					UE_LOG(LogEasyMultiSave, Warning, TEXT("ExportSaveThumbnailRT: Could not write %s"), *SaveThumbnailName);
+				}
 
-			delete Ar;
-		}
-		else
+				WritePromise->SetValue(bSuccess ? 0 : int64(INDEX_NONE));
+			});
+		});
+	}
+}
+
+UTexture2D* UEMSObject::FindCachedThumbnail(const FString& ThumbnailFile, const FDateTime& TimeStamp)
+{
+	FThumbnailCacheEntry* CacheEntry = ThumbnailCache.Find(ThumbnailFile);
+	if (CacheEntry && CacheEntry->Texture && CacheEntry->TimeStamp == TimeStamp)
+	{
+		CacheEntry->LastUsed = ++ThumbnailCacheCounter;
+		return CacheEntry->Texture;
+	}
+
+	return nullptr;
+}
+
+void UEMSObject::AddCachedThumbnail(const FString& ThumbnailFile, const FDateTime& TimeStamp, UTexture2D* Texture)
+{
+	const int32 MaxCacheSize = UEMSPluginSettings::Get()->ThumbnailCacheSize;
+	if (!Texture || MaxCacheSize <= 0)
+	{
+		return;
+	}
+
+	ThumbnailCache.Remove(ThumbnailFile);
+
+	//Release the least recently used thumbnails.
+	while (ThumbnailCache.Num() >= MaxCacheSize)
+	{
+		FString OldestFile;
+		uint64 OldestUse = MAX_uint64;
+
+		for (const TPair<FString, FThumbnailCacheEntry>& CacheEntry : ThumbnailCache)
 		{
-			UE_LOG(LogEasyMultiSave, Warning, TEXT("ExportSaveThumbnailRT: FileWrite failed to create"));
+			if (CacheEntry.Value.LastUsed < OldestUse)
+			{
+				OldestUse = CacheEntry.Value.LastUsed;
+				OldestFile = CacheEntry.Key;
+			}
 		}
+
+		ThumbnailCache.Remove(OldestFile);
 	}
-	
+
+	FThumbnailCacheEntry CacheEntry;
+	CacheEntry.Texture = Texture;
+	CacheEntry.TimeStamp = TimeStamp;
+	CacheEntry.LastUsed = ++ThumbnailCacheCounter;
+
+	ThumbnailCache.Add(ThumbnailFile, CacheEntry);
 }
 
@@ -10,7 +10,7 @@
 #include "EMSActorSaveInterface.generated.h"
 
 UINTERFACE(Category = "Easy Multi Save", BlueprintType, meta = (DisplayName = "EMS Save Interface"))
-class UEMSActorSaveInterface : public UInterface
+class EASYMULTISAVE_API UEMSActorSaveInterface : public UInterface
 {
 	GENERATED_BODY()
 };
@@ -71,6 +71,7 @@ private:
 	void FailLoadingTask();
 
 	void DeferredLoadActors();
+	void BudgetedLoadActors();
 
 	void ClearFailTimer();
 
@@ -12,6 +12,7 @@
 class UEMSObject;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FAsyncSaveOutputPin);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FAsyncSaveFailedPin);
 
 UENUM()
 enum class ENextStepType : uint8
@@ -30,8 +31,14 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FAsyncSaveOutputPin OnCompleted;
 
+	UPROPERTY(BlueprintAssignable)
+	FAsyncSaveFailedPin OnFailed;
+
 	bool bIsActive;
 
+	//Waiting for the running save to finish.
+	bool bIsQueued;
+
 	ESaveGameMode Mode;
 
 private:
@@ -44,6 +51,12 @@ private:
 
 	bool bFinishedStep;
 
+	//Requests that were merged into this save and complete with it.
+	UPROPERTY(Transient)
+	TArray<UEMSAsyncSaveGame*> MergedTasks;
+
+	bool bIsMerged;
+
 public:
 
 	/**
@@ -56,6 +69,9 @@ public:
 
 	virtual void Activate() override;
 
+	void StartSaveTask();
+	void MergeTask(UEMSAsyncSaveGame* SaveTask);
+
 private:
 
 	void StartSaving();
@@ -68,6 +84,7 @@ private:
 
 	void FinishSaving();
 	void CompleteSavingTask();
+	void FailSavingTask();
 
 	void TryMoveToNextStep(ENextStepType Step);
 
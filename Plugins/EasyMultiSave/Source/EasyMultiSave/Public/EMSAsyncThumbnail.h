@@ -0,0 +1,51 @@
+//Easy Multi Save - Copyright (C) 2022 by Michael Hegemann.  
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "EMSData.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "EMSAsyncThumbnail.generated.h"
+
+class UEMSObject;
+class UTexture2D;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAsyncThumbnailOutputPin, UTexture2D*, Thumbnail);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FAsyncThumbnailFailedPin);
+
+UCLASS()
+class EASYMULTISAVE_API UEMSAsyncThumbnail : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+	
+public:
+
+	virtual void Activate() override;
+
+public:
+
+	UPROPERTY(BlueprintAssignable)
+	FAsyncThumbnailOutputPin OnCompleted;
+
+	UPROPERTY(BlueprintAssignable)
+	FAsyncThumbnailFailedPin OnFailed;
+
+	/**
+	* Imports a thumbnail as .png from the save game folder without blocking the game thread.
+	* Recently imported thumbnails are returned from memory.
+	*
+	* @param SaveGameName - The name of the Savegame/Slot that is tied to the thumbnail.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Easy Multi Save | Thumbnail", meta = (DisplayName = "Import Save Thumbnail Async", BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UEMSAsyncThumbnail* AsyncImportSaveThumbnail(UObject* WorldContextObject, const FString& SaveGameName);
+
+private:
+
+	UObject* WorldContextObject;
+	UEMSObject* EMS;
+
+	FString SaveGameName;
+
+	void CompleteThumbnailTask(UTexture2D* Thumbnail);
+};
@@ -9,6 +9,8 @@
 #include "Serialization/ObjectAndNameAsStringProxyArchive.h"
 #include "EMSData.generated.h"
 
+class UTexture2D;
+
 static const FName HasLoadedTag(TEXT("EMS_HasLoaded"));
 static const FName SkipSaveTag(TEXT("EMS_SkipSave"));
 static const FName PersistentTag(TEXT("EMS_Persistent"));
@@ -20,7 +22,9 @@ static const FString Slash(TEXT("/"));
 static const FString SaveType(TEXT(".sav"));
 static const FString PlayerSuffix(TEXT("Player"));
 static const FString ActorSuffix(TEXT("Level"));
+static const FString JournalSuffix(TEXT("LevelDelta"));
 static const FString SlotSuffix(TEXT("Slot"));
+static const FString SlotIndexName(TEXT("SlotIndex"));
 
 template <typename TArrayType>
 FORCEINLINE static bool ArrayEmpty(const TArrayType& InArray) {return InArray.Num() <= 0;}
@@ -39,6 +43,7 @@ enum class EDataLoadType : uint8
 	DATA_Level,
 	DATA_Player, 
 	DATA_Object,
+	DATA_Journal,
 };
 
 UENUM()
@@ -82,6 +87,12 @@ enum class ELoadMethod: uint8
 	Try to use deferred loading when possible, since it is more stable.
 	*/
 	LM_Thread   UMETA(DisplayName = "Multi-Thread"),
+
+	/** 
+	Like deferred loading, but the number of Actors per frame is based on a time budget. 
+	Useful for streaming loads that need a stable frame rate.
+	*/
+	LM_Budgeted   UMETA(DisplayName = "Time Budget"),
 };
 
 UENUM()
@@ -130,6 +141,22 @@ enum class EMultiLevelSaveMethod : uint8
 	ML_Slow   UMETA(DisplayName = "Persistent"),
 };
 
+UENUM()
+enum class ESaveCompressionCodec : uint8
+{
+	/** Compatible with all versions of the plugin. */
+	SC_Zlib   UMETA(DisplayName = "Zlib"),
+
+	/** Very fast compression and decompression, slightly larger files. */
+	SC_LZ4   UMETA(DisplayName = "LZ4"),
+
+	/** Fast decompression and small files. Falls back to Zlib if Oodle is not available. */
+	SC_Oodle   UMETA(DisplayName = "Oodle"),
+
+	/** No compression. Always used with the console file system. */
+	SC_None   UMETA(DisplayName = "None"),
+};
+
 #define ENUM_TO_FLAG(Enum) (1 << static_cast<uint8>(Enum)) 
 
 USTRUCT(BlueprintType)
@@ -150,6 +177,137 @@ struct FSaveSlotInfo
 	TArray<FString> Players;
 };
 
+USTRUCT()
+struct FSaveSlotIndexEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+	FString Name;
+	FDateTime TimeStamp;
+	FName Level;
+	FString Thumbnail;
+
+	friend FArchive& operator<<(FArchive& Ar, FSaveSlotIndexEntry& Entry)
+	{
+		Ar << Entry.Name;
+		Ar << Entry.TimeStamp;
+		Ar << Entry.Level;
+		Ar << Entry.Thumbnail;
+		return Ar;
+	}
+};
+
+static const uint32 SlotIndexMagic = 0x58495345;
+static const uint32 SlotIndexVersion = 1;
+
+USTRUCT()
+struct FSaveSlotIndex
+{
+	GENERATED_USTRUCT_BODY()
+
+	uint32 Magic = SlotIndexMagic;
+	uint32 Version = SlotIndexVersion;
+
+	//Newest slot first.
+	TArray<FSaveSlotIndexEntry> Slots;
+
+	friend FArchive& operator<<(FArchive& Ar, FSaveSlotIndex& Index)
+	{
+		Ar << Index.Magic;
+
+		if (Index.Magic == SlotIndexMagic)
+		{
+			Ar << Index.Version;
+
+			if (Index.Version == SlotIndexVersion)
+			{
+				Ar << Index.Slots;
+			}
+		}
+
+		return Ar;
+	}
+
+	FORCEINLINE bool IsValid() const
+	{
+		return Magic == SlotIndexMagic && Version == SlotIndexVersion;
+	}
+
+	FORCEINLINE FSaveSlotIndexEntry* FindSlot(const FString& SlotName)
+	{
+		return Slots.FindByPredicate([&SlotName](const FSaveSlotIndexEntry& Entry)
+		{
+			return Entry.Name == SlotName;
+		});
+	}
+
+	FORCEINLINE void Sort()
+	{
+		Slots.Sort([](const FSaveSlotIndexEntry& A, const FSaveSlotIndexEntry& B)
+		{
+			return A.TimeStamp > B.TimeStamp;
+		});
+	}
+};
+
+USTRUCT()
+struct FThumbnailCacheEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	UTexture2D* Texture = nullptr;
+
+	//File time stamp, a newer thumbnail is imported again.
+	FDateTime TimeStamp;
+	uint64 LastUsed = 0;
+};
+
+USTRUCT()
+struct FOperationCounters
+{
+	GENERATED_USTRUCT_BODY()
+
+	int32 ActorsGathered = 0;
+	int32 ActorsSaved = 0;
+	int32 ActorsSpawned = 0;
+	int32 ActorsUpdated = 0;
+	int64 ArchiveBytes = 0;
+
+	//Added on the game thread once the file writes are done.
+	int64 CompressedBytes = 0;
+
+	uint64 StartFrame = 0;
+
+	FORCEINLINE void Start()
+	{
+		*this = FOperationCounters();
+		StartFrame = GFrameCounter;
+	}
+
+	FORCEINLINE uint64 GetFrameSpan() const
+	{
+		return GFrameCounter - StartFrame + 1;
+	}
+};
+
+USTRUCT()
+struct FActorLoadTimings
+{
+	GENERATED_USTRUCT_BODY()
+
+	double SpawnTime = 0.0;
+	double DeserializeTime = 0.0;
+	int32 SpawnNum = 0;
+	int32 DeserializeNum = 0;
+
+	FORCEINLINE double GetAverageTime() const
+	{
+		const int32 Num = FMath::Max(1, DeserializeNum);
+		return (SpawnTime + DeserializeTime) / Num;
+	}
+};
+
 USTRUCT()
 struct FComponentSaveData
 {
@@ -182,6 +340,88 @@ struct FGameObjectSaveData
 		Ar << GameObjectData.Components;
 		return Ar;
 	}
+
+	static void Skip(FArchive& Ar)
+	{
+		//Moves past the serialized data without allocating anything.
+		SkipBytes(Ar);
+
+		int32 ComponentNum = 0;
+		Ar << ComponentNum;
+
+		for (int32 Index = 0; Index < ComponentNum && !Ar.IsError(); Index++)
+		{
+			SkipBytes(Ar);
+
+			FTransform RelativeTransform;
+			Ar << RelativeTransform;
+
+			SkipBytes(Ar);
+		}
+	}
+
+	FORCEINLINE static void SkipBytes(FArchive& Ar)
+	{
+		int32 ByteNum = 0;
+		Ar << ByteNum;
+
+		if (ByteNum > 0)
+		{
+			Ar.Seek(Ar.Tell() + ByteNum);
+		}
+	}
+};
+
+USTRUCT()
+struct FSaveStringTable
+{
+	GENERATED_USTRUCT_BODY()
+
+	//Class paths and level names, written once per archive and referenced by index.
+	TArray<FName> Names;
+	TMap<FName, int32> Indices;
+
+	friend FArchive& operator<<(FArchive& Ar, FSaveStringTable& Table)
+	{
+		Ar << Table.Names;
+		return Ar;
+	}
+
+	FORCEINLINE int32 Add(const FName& Name)
+	{
+		if (Name.IsNone())
+		{
+			return INDEX_NONE;
+		}
+
+		//Only the plain part is stored, numbered names share one entry.
+		const FName PlainName(Name, 0);
+		if (const int32* Index = Indices.Find(PlainName))
+		{
+			return *Index;
+		}
+
+		return Indices.Add(PlainName, Names.Add(PlainName));
+	}
+
+	FORCEINLINE FName Get(const int32 Index, const int32 Number = 0) const
+	{
+		return Names.IsValidIndex(Index) ? FName(Names[Index], Number) : NAME_None;
+	}
+
+	FORCEINLINE void SerializeName(FArchive& Ar, FName& Name)
+	{
+		int32 Index = Ar.IsSaving() ? Add(Name) : INDEX_NONE;
+		int32 Number = Name.GetNumber();
+
+		Ar << Index;
+		Ar << Number;
+
+		if (Ar.IsLoading())
+		{
+			Name = Get(Index, Number);
+		}
+	}
 };
 
 USTRUCT()
@@ -189,8 +429,8 @@ struct FActorSaveData
 {
 	GENERATED_USTRUCT_BODY()
 
-	TArray<uint8> Class;     
-	TArray<uint8> Name;
+	FName Class;     
+	FName Name;
 	FTransform Transform;  
 	uint8 Type;
 	FGameObjectSaveData SaveData;
@@ -205,6 +445,36 @@ struct FActorSaveData
 		return Ar;
 	}
 
+	FORCEINLINE void SerializeIndexed(FArchive& Ar, FSaveStringTable& Table)
+	{
+		SerializeIndexedHeader(Ar, Table);
+		Ar << SaveData;
+	}
+
+	FORCEINLINE void SerializeIndexedHeader(FArchive& Ar, FSaveStringTable& Table)
+	{
+		Table.SerializeName(Ar, Class);
+		Table.SerializeName(Ar, Name);
+		Ar << Transform;
+		Ar << Type;
+	}
+
+	FORCEINLINE void SerializeLegacy(FArchive& Ar)
+	{
+		//Older saves store names as string bytes.
+		TArray<uint8> ClassBytes;
+		TArray<uint8> NameBytes;
+
+		Ar << ClassBytes;
+		Ar << NameBytes;
+		Ar << Transform;
+		Ar << Type;
+		Ar << SaveData;
+
+		Class = ArrayEmpty(ClassBytes) ? NAME_None : FName(*BytesToString(ClassBytes.GetData(), ClassBytes.Num()));
+		Name = FName(*BytesToString(NameBytes.GetData(), NameBytes.Num()));
+	}
+
 	FORCEINLINE bool operator ==(const FActorSaveData& A) const
 	{
 		return A.Name == Name;
@@ -232,6 +502,8 @@ struct FLevelScriptSaveData
 	}
 };
 
+static const uint32 LevelArchiveMagic = 0x414C4D45;
+
 USTRUCT()
 struct FLevelArchive
 {
@@ -245,14 +517,139 @@ struct FLevelArchive
 
 	friend FArchive& operator<<(FArchive& Ar, FLevelArchive& LevelArchive)
 	{
-		Ar << LevelArchive.SavedActors;
-		Ar << LevelArchive.SavedScripts;
-		Ar << LevelArchive.SavedGameMode;
-		Ar << LevelArchive.SavedGameState;
-		Ar << LevelArchive.Level;
+		if (Ar.IsLoading())
+		{
+			LevelArchive.Load(Ar);
+		}
+		else
+		{
+			TArray<FActorSaveData*> Actors;
+			for (FActorSaveData& ActorData : LevelArchive.SavedActors)
+			{
+				Actors.Add(&ActorData);
+			}
+
+			TArray<FLevelScriptSaveData*> Scripts;
+			for (FLevelScriptSaveData& ScriptData : LevelArchive.SavedScripts)
+			{
+				Scripts.Add(&ScriptData);
+			}
+
+			Save(Ar, Actors, Scripts, LevelArchive.SavedGameMode, LevelArchive.SavedGameState, LevelArchive.Level);
+		}
+
 		return Ar;
 	}
 
+	static void Save(FArchive& Ar, const TArray<FActorSaveData*>& Actors, const TArray<FLevelScriptSaveData*>& Scripts, FGameObjectSaveData& GameMode, FGameObjectSaveData& GameState, FName& Level)
+	{
+		uint32 Magic = LevelArchiveMagic;
+		Ar << Magic;
+
+		//Fill the table first, so records can reference it when loading.
+		FSaveStringTable Table;
+		for (const FActorSaveData* ActorData : Actors)
+		{
+			Table.Add(ActorData->Class);
+			Table.Add(ActorData->Name);
+		}
+
+		for (const FLevelScriptSaveData* ScriptData : Scripts)
+		{
+			Table.Add(ScriptData->Name);
+		}
+
+		Table.Add(Level);
+		Ar << Table;
+
+		int32 ActorNum = Actors.Num();
+		Ar << ActorNum;
+
+		for (FActorSaveData* ActorData : Actors)
+		{
+			ActorData->SerializeIndexed(Ar, Table);
+		}
+
+		int32 ScriptNum = Scripts.Num();
+		Ar << ScriptNum;
+
+		for (FLevelScriptSaveData* ScriptData : Scripts)
+		{
+			Table.SerializeName(Ar, ScriptData->Name);
+			Ar << ScriptData->SaveData;
+		}
+
+		Ar << GameMode;
+		Ar << GameState;
+		Table.SerializeName(Ar, Level);
+	}
+
+	//Records named in SkipActors are passed over without reading their data.
+	void Load(FArchive& Ar, const TSet<FName>* SkipActors = nullptr)
+	{
+		const int64 Start = Ar.Tell();
+
+		uint32 Magic = 0;
+		Ar << Magic;
+
+		//Older saves have no string table and start with the Actor count.
+		if (Magic != LevelArchiveMagic)
+		{
+			Ar.Seek(Start);
+
+			int32 ActorNum = 0;
+			Ar << ActorNum;
+
+			SavedActors.SetNum(FMath::Max(0, ActorNum));
+			for (FActorSaveData& ActorData : SavedActors)
+			{
+				ActorData.SerializeLegacy(Ar);
+			}
+
+			Ar << SavedScripts;
+			Ar << SavedGameMode;
+			Ar << SavedGameState;
+			Ar << Level;
+			return;
+		}
+
+		FSaveStringTable Table;
+		Ar << Table;
+
+		int32 ActorNum = 0;
+		Ar << ActorNum;
+
+		SavedActors.Reserve(FMath::Max(0, ActorNum));
+		for (int32 Index = 0; Index < ActorNum && !Ar.IsError(); Index++)
+		{
+			FActorSaveData ActorData;
+			ActorData.SerializeIndexedHeader(Ar, Table);
+
+			if (SkipActors && SkipActors->Contains(ActorData.Name))
+			{
+				FGameObjectSaveData::Skip(Ar);
+				continue;
+			}
+
+			Ar << ActorData.SaveData;
+			SavedActors.Add(MoveTemp(ActorData));
+		}
+
+		int32 ScriptNum = 0;
+		Ar << ScriptNum;
+
+		SavedScripts.SetNum(FMath::Max(0, ScriptNum));
+		for (FLevelScriptSaveData& ScriptData : SavedScripts)
+		{
+			Table.SerializeName(Ar, ScriptData.Name);
+			Ar << ScriptData.SaveData;
+		}
+
+		Ar << SavedGameMode;
+		Ar << SavedGameState;
+		Table.SerializeName(Ar, Level);
+	}
+
 	FORCEINLINE bool operator ==(const FLevelArchive& A) const
 	{
 		return A.Level == Level;
@@ -297,46 +694,145 @@ struct FLevelStackArchive
 	}
 };
 
+USTRUCT()
+struct FLevelDeltaSegment
+{
+	GENERATED_USTRUCT_BODY()
+
+	TArray<FActorSaveData> ChangedActors;
+	TArray<FName> RemovedActors;
+	TArray<FLevelScriptSaveData> SavedScripts;
+	FGameObjectSaveData SavedGameMode;
+	FGameObjectSaveData SavedGameState;
+
+	friend FArchive& operator<<(FArchive& Ar, FLevelDeltaSegment& Segment)
+	{
+		Ar << Segment.ChangedActors;
+		Ar << Segment.RemovedActors;
+		Ar << Segment.SavedScripts;
+		Ar << Segment.SavedGameMode;
+		Ar << Segment.SavedGameState;
+		return Ar;
+	}
+};
+
+USTRUCT()
+struct FLevelDeltaJournal
+{
+	GENERATED_USTRUCT_BODY()
+
+	//The level of the full archive that the segments are applied to.
+	FName Level;
+
+	//Checksum of the uncompressed full archive, the segments are never applied to another one.
+	uint32 BaseChecksum = 0;
+
+	TArray<FLevelDeltaSegment> Segments;
+
+	friend FArchive& operator<<(FArchive& Ar, FLevelDeltaJournal& Journal)
+	{
+		Ar << Journal.Level;
+		Ar << Journal.BaseChecksum;
+		Ar << Journal.Segments;
+		return Ar;
+	}
+};
+
 USTRUCT(BlueprintType)
 struct FMultiLevelStreamingData
 {
 	GENERATED_USTRUCT_BODY()
 
-	TArray<FActorSaveData> Actors;
-	TArray<FLevelScriptSaveData> Scripts;
+	TMap<FName, FActorSaveData> Actors;
+	TMap<FName, FLevelScriptSaveData> Scripts;
+
+	//Actor names per streaming level. Only known for Actors that were saved in this session.
+	TMap<FName, TSet<FName>> LevelActors;
+
+	FORCEINLINE static FName GetActorKey(const FActorSaveData& ActorData)
+	{
+		return ActorData.Name;
+	}
 
 	FORCEINLINE void CopyFrom(const FLevelArchive& A)
 	{
-		Actors = A.SavedActors;
-		Scripts = A.SavedScripts;
+		Actors.Empty(A.SavedActors.Num());
+		Scripts.Empty(A.SavedScripts.Num());
+		LevelActors.Empty();
+
+		for (const FActorSaveData& ActorData : A.SavedActors)
+		{
+			Actors.Add(GetActorKey(ActorData), ActorData);
+		}
+
+		for (const FLevelScriptSaveData& ScriptData : A.SavedScripts)
+		{
+			Scripts.Add(ScriptData.Name, ScriptData);
+		}
 	}
 
-	template <typename TSaveData, typename TSaveDataArray>
-	FORCEINLINE void ReplaceOrAddToArray(const TSaveData& Data, TSaveDataArray& OuputArray)
+	void ReplaceOrAdd(TArray<FActorSaveData>&& InActors, const TArray<FName>& InActorLevels, TArray<FLevelScriptSaveData>&& InScripts)
 	{
+		check(InActors.Num() == InActorLevels.Num());
+
+		TMap<FName, TSet<FName>> SavedLevelActors;
+
 		//This will replace an existing element or add a new one. 
-		const uint32 Index = OuputArray.Find(Data);
-		if (Index != INDEX_NONE)
+		for (int32 Index = 0; Index < InActors.Num(); ++Index)
 		{
-			OuputArray[Index] = Data;
+			const FName ActorName = GetActorKey(InActors[Index]);
+			SavedLevelActors.FindOrAdd(InActorLevels[Index]).Add(ActorName);
+
+			Actors.Add(ActorName, MoveTemp(InActors[Index]));
 		}
-		else
+
+		//Actors that are gone from a level that was just saved are stale.
+		for (TPair<FName, TSet<FName>>& SavedLevel : SavedLevelActors)
 		{
-			OuputArray.Add(Data);
-		}	
+			if (const TSet<FName>* PreviousActors = LevelActors.Find(SavedLevel.Key))
+			{
+				for (const FName& ActorName : *PreviousActors)
+				{
+					if (!SavedLevel.Value.Contains(ActorName))
+					{
+						Actors.Remove(ActorName);
+					}
+				}
+			}
+
+			LevelActors.Add(SavedLevel.Key, MoveTemp(SavedLevel.Value));
+		}
+
+		for (FLevelScriptSaveData& ScriptData : InScripts)
+		{
+			const FName ScriptName = ScriptData.Name;
+			Scripts.Add(ScriptName, MoveTemp(ScriptData));
+		}
+
+		InActors.Reset();
+		InScripts.Reset();
 	}
 
-	FORCEINLINE void ReplaceOrAdd(const FLevelArchive& A)
+	void SerializeLevel(FArchive& Ar, FLevelArchive& A)
 	{
-		for (const FActorSaveData& ActorData : A.SavedActors)
+		//Same layout as FLevelArchive, but written directly from memory.
+		TArray<FActorSaveData*> ActorPtrs;
+		ActorPtrs.Reserve(Actors.Num());
+
+		for (TPair<FName, FActorSaveData>& ActorData : Actors)
 		{
-			ReplaceOrAddToArray(ActorData, Actors);
+			ActorPtrs.Add(&ActorData.Value);
 		}
-		
-		for (const FLevelScriptSaveData& ScriptData : A.SavedScripts)
+
+		TArray<FLevelScriptSaveData*> ScriptPtrs;
+		ScriptPtrs.Reserve(Scripts.Num());
+
+		for (TPair<FName, FLevelScriptSaveData>& ScriptData : Scripts)
 		{
-			ReplaceOrAddToArray(ScriptData, Scripts);
-		}		
+			ScriptPtrs.Add(&ScriptData.Value);
+		}
+
+		FLevelArchive::Save(Ar, ActorPtrs, ScriptPtrs, A.SavedGameMode, A.SavedGameState, A.Level);
 	}
 };
 
@@ -446,6 +942,114 @@ struct FPlayerStackArchive
 	}
 };
 
+static const uint32 SaveFileMagic = 0x53464D45;
+static const uint32 SaveFileVersion = 2;
+
+//Upper bound for the size stored in a file header, so a corrupt file cannot request a huge buffer.
+static const int64 SaveFileMaxUncompressedSize = 1024ll * 1024ll * 1024ll;
+
+USTRUCT()
+struct FSaveFileHeader
+{
+	GENERATED_USTRUCT_BODY()
+
+	uint32 Magic = SaveFileMagic;
+	uint32 Version = SaveFileVersion;
+	uint8 Codec = uint8(ESaveCompressionCodec::SC_None);
+	int64 UncompressedSize = 0;
+	uint32 Checksum = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FSaveFileHeader& Header)
+	{
+		Ar << Header.Magic;
+
+		//Files from older versions have no header, so nothing else is read.
+		if (Header.Magic == SaveFileMagic)
+		{
+			Ar << Header.Version;
+			Ar << Header.Codec;
+			Ar << Header.UncompressedSize;
+			Ar << Header.Checksum;
+		}
+
+		return Ar;
+	}
+
+	FORCEINLINE bool IsValid() const
+	{
+		return Magic == SaveFileMagic && Version <= SaveFileVersion;
+	}
+};
+
+static const uint32 LevelChunkMagic = 0x434C4D45;
+
+USTRUCT()
+struct FLevelChunk
+{
+	GENERATED_USTRUCT_BODY()
+
+	FName Level;
+	FSaveFileHeader Header;
+	TArray<uint8> Data;
+
+	friend FArchive& operator<<(FArchive& Ar, FLevelChunk& Chunk)
+	{
+		Ar << Chunk.Level;
+		Ar << Chunk.Header;
+		Ar << Chunk.Data;
+		return Ar;
+	}
+};
+
+USTRUCT()
+struct FLevelChunkArchive
+{
+	GENERATED_USTRUCT_BODY()
+
+	uint32 Magic = LevelChunkMagic;
+
+	//Each level is compressed on its own, so only the desired level needs to be unpacked.
+	TArray<FLevelChunk> Chunks;
+
+	FGameObjectSaveData SavedGameMode;
+	FGameObjectSaveData SavedGameState;
+
+	friend FArchive& operator<<(FArchive& Ar, FLevelChunkArchive& ChunkArchive)
+	{
+		Ar << ChunkArchive.Magic;
+
+		//Older saves use FLevelStackArchive, which has no magic.
+		if (ChunkArchive.Magic == LevelChunkMagic)
+		{
+			Ar << ChunkArchive.Chunks;
+			Ar << ChunkArchive.SavedGameMode;
+			Ar << ChunkArchive.SavedGameState;
+		}
+
+		return Ar;
+	}
+
+	FORCEINLINE FLevelChunk* FindChunk(const FName& Level)
+	{
+		return Chunks.FindByPredicate([&Level](const FLevelChunk& Chunk)
+		{
+			return Chunk.Level == Level;
+		});
+	}
+
+	FORCEINLINE void ReplaceOrAdd(FLevelChunk&& NewChunk)
+	{
+		if (FLevelChunk* ExistingChunk = FindChunk(NewChunk.Level))
+		{
+			*ExistingChunk = MoveTemp(NewChunk);
+		}
+		else
+		{
+			Chunks.Add(MoveTemp(NewChunk));
+		}
+	}
+};
+
 struct FSaveGameArchive : public FObjectAndNameAsStringProxyArchive
 {
 	FSaveGameArchive(FArchive& InInnerArchive) : FObjectAndNameAsStringProxyArchive(InInnerArchive, true)
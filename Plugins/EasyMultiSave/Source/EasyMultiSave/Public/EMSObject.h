@@ -9,6 +9,8 @@
 #include "Serialization/BufferArchive.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/MemoryWriter.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "Engine/EngineTypes.h"
 #include "Kismet/KismetRenderingLibrary.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
@@ -22,6 +24,7 @@
 #include "EMSObject.generated.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogEasyMultiSave, Log, All);
+DECLARE_STATS_GROUP(TEXT("EasyMultiSave"), STATGROUP_EasyMultiSave, STATCAT_Advanced);
 
 const int PlayerIndex = 0;
 
@@ -33,6 +36,7 @@ class EASYMULTISAVE_API UEMSObject : public UGameInstanceSubsystem
 public:
 
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
 
 /** Variables */
 
@@ -54,7 +58,10 @@ public:
 	TArray<AActor*> ActorList;
 
 	UPROPERTY(Transient)
-	TArray<FLevelArchive> LevelArchiveList;	
+	TMap<FName, AActor*> ActorMap;
+
+	UPROPERTY(Transient)
+	FLevelChunkArchive LevelChunkStack;
 
 	UPROPERTY(Transient)
 	FMultiLevelStreamingData MultiLevelStreamData;
@@ -62,6 +69,13 @@ public:
 	UPROPERTY(Transient)
 	FPlayerStackArchive PlayerStackData;
 
+	UPROPERTY(Transient)
+	FLevelDeltaJournal LevelDeltaJournal;
+
+	TMap<FName, uint32> LevelDeltaHashes;
+	bool bHasLevelDeltaBase;
+	uint32 LoadedLevelChecksum;
+
 	UPROPERTY(Transient)
 	TArray<FActorSaveData> SavedActors;
 
@@ -83,6 +97,45 @@ public:
 	UPROPERTY(Transient)
 	FGameObjectSaveData SavedPlayerState;
 
+	UPROPERTY(Transient)
+	FActorLoadTimings LoadTimings;
+
+	//Counters of the current save or load, logged when it is done.
+	UPROPERTY(Transient)
+	FOperationCounters OperationCounters;
+
+	//Running save first, followed by at most one queued save.
+	UPROPERTY(Transient)
+	TArray<UEMSAsyncSaveGame*> SaveTasks;
+
+	UPROPERTY(Transient)
+	TArray<UEMSAsyncLoadGame*> LoadTasks;
+
+	UPROPERTY(Transient)
+	TMap<FString, FThumbnailCacheEntry> ThumbnailCache;
+
+	uint64 ThumbnailCacheCounter;
+
+private:
+
+	FCriticalSection PendingWriteSection;
+	//Bytes written to disk, or INDEX_NONE if the write failed.
+	TMap<FString, TFuture<int64>> PendingWrites;
+
+	//Writes that failed since the last reset, also counts background writes.
+	FThreadSafeCounter FailedWrites;
+
+	//Classes and structs whose struct properties are already flagged for saving
+	TSet<TWeakObjectPtr<const UStruct>> PreparedStructs;
+
+	//Classes of runtime Actors, so each saved class path is only resolved once. Only written on the game thread.
+	TMap<FName, TWeakObjectPtr<UClass>> SpawnClasses;
+
+	//Served for slot browsing, kept in sync with the slot index file of the current user
+	mutable FSaveSlotIndex SlotIndex;
+	mutable FString SlotIndexUser;
+	mutable bool bSlotIndexLoaded = false;
+
 /** Blueprint Library function accessors */
 	
 public:
@@ -98,6 +151,7 @@ public:
 	TArray<FString> GetAllSaveUsers() const;
 
 	UTexture2D* ImportSaveThumbnail(const FString& SaveGameName);
+	void ImportSaveThumbnailAsync(const FString& SaveGameName, TFunction<void(UTexture2D*)>&& OnImported);
 	void ExportSaveThumbnail(UTextureRenderTarget2D* TextureRenderTarget, const FString& SaveGameName);
 
 	void DeleteAllSaveDataForSlot(const FString& SaveGameName);
@@ -132,6 +186,8 @@ public:
 	bool SpawnOrUpdateLevelActor(const FActorSaveData& ActorArray);
 	EUpdateActorResult UpdateLevelActor(const FActorSaveData& ActorArray);
 	void SpawnLevelActor(const FActorSaveData& ActorArray);
+	UClass* GetSpawnClass(const FName& ClassPath);
+	void PrepareSpawnClasses();
 	void ProcessLevelActor(AActor* Actor, const FActorSaveData& ActorArray);
 
 	bool TryLoadPlayerFile();
@@ -144,6 +200,21 @@ public:
 
 	bool IsAsyncSaveOrLoadTaskActive(const ESaveGameMode& Mode = ESaveGameMode::MODE_All, const EAsyncCheckType& CheckType = EAsyncCheckType::CT_Both, const bool& bLogAndReturnError = true) const;
 
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	void RegisterSaveTask(UEMSAsyncSaveGame* SaveTask);
+	void UnregisterSaveTask(UEMSAsyncSaveGame* SaveTask);
+	void RegisterLoadTask(UEMSAsyncLoadGame* LoadTask);
+	void UnregisterLoadTask(UEMSAsyncLoadGame* LoadTask);
+
+	void LogOperationCounters(const FString& OperationName) const;
+
+	bool HasPendingWrites();
+	void WaitForPendingWrites();
+
+	FORCEINLINE bool HasFailedWrites() const { return FailedWrites.GetValue() > 0; }
+	FORCEINLINE void ResetFailedWrites() { FailedWrites.Reset(); }
+
 	bool HasValidGameMode() const;
 	bool HasValidPlayer() const;
 
@@ -153,11 +224,19 @@ protected:
 
 	bool VerifyOrCreateDirectory(const FString& NewDir);
 
-	bool SaveBinaryArchive(FBufferArchive& BinaryData, const FString& FullSavePath);
+	bool SaveBinaryArchive(FBufferArchive& BinaryData, const FString& FullSavePath, const bool bCompress = true, TFunction<void()> OnWritten = nullptr);
+	bool WaitForPendingWrite(const FString& FullSavePath);
+	bool CompletePendingWrite(const int64 WrittenBytes);
 	bool LoadBinaryArchive(const EDataLoadType& LoadType, const FString& FullSavePath, UObject* Object = nullptr);
-	bool UnpackBinaryArchive(const EDataLoadType& LoadType, FMemoryReader FromBinary, UObject* Object = nullptr);
-	bool UnpackLevel(const FLevelArchive& LevelArchive);
+	bool LoadMappedBinaryArchive(const EDataLoadType& LoadType, const FString& FullSavePath, UObject* Object, bool& bOutSuccess);
+	bool UnpackBinaryArchive(const EDataLoadType& LoadType, FArchive& FromBinary, UObject* Object = nullptr);
+	bool UnpackLevel(FLevelArchive& LevelArchive);
+	TSet<FName> GetLoadedActorNames() const;
 	bool UnpackPlayer(const FPlayerArchive& PlayerArchive);
+
+	bool SaveLevelDelta(const FLevelArchive& LevelArchive);
+	void ApplyLevelDelta(FLevelArchive& LevelArchive);
+	uint32 GetActorDataHash(const FActorSaveData& ActorArray) const;
 	
 	void DirectSetPlayerPosition(const FPlayerPositionArchive& PosArchive);
 	
@@ -166,6 +245,7 @@ protected:
 	USaveGame* LoadObject(const FString& FullSavePath, TSubclassOf<USaveGame> SaveGameClass);
 
 	void SaveActorToBinary(AActor* Actor, FGameObjectSaveData& OutData);
+	void SaveActorsToBinaryParallel(const TArray<AActor*>& Actors, TArray<FActorSaveData>& OutActors);
 	void LoadActorFromBinary(AActor* Actor, const FGameObjectSaveData& InData);
 
 	void SerializeToBinary(UObject* Object, TArray<uint8>& OutData);
@@ -176,8 +256,10 @@ protected:
 	void SerializeScriptStruct(UStruct* ScriptStruct);
 	void SerializeArrayStruct(FArrayProperty* ArrayProp);
 	void SerializeMap(FMapProperty* MapProp);
+	bool MarkStructPrepared(const UStruct* Struct);
 
 	void SaveActorComponents(AActor* Actor, TArray<FComponentSaveData>& OutComponents);
+	void GatherActorComponents(AActor* Actor, TArray<FComponentSaveData>& OutComponents, TArray<UObject*>& OutObjects);
 	void LoadActorComponents(AActor* Actor, const TArray<FComponentSaveData>& InComponents);
 
 	bool HasSaveInterface(const AActor* Actor) const;
@@ -189,6 +271,8 @@ protected:
 
 	bool CheckForExistingActor(const FActorSaveData& ActorArray);
 
+	AActor* FindActorForSaveData(const FActorSaveData& ActorArray) const;
+
 	EActorType GetActorType(const AActor* Actor) const;
     bool IsMovable(const USceneComponent* SceneComp) const;
 
@@ -200,6 +284,15 @@ protected:
 	TArray<FString> GetSaveSlotsDesktop() const;
 	TArray<FString> GetSaveSlotsConsole() const;
 
+	UTexture2D* FindCachedThumbnail(const FString& ThumbnailFile, const FDateTime& TimeStamp);
+	void AddCachedThumbnail(const FString& ThumbnailFile, const FDateTime& TimeStamp, UTexture2D* Texture);
+
+	void ValidateSlotIndex(const TArray<FString>& SlotNames) const;
+	void LoadSlotIndex() const;
+	void SaveSlotIndex() const;
+	void UpdateSlotIndex(const FSaveSlotInfo& SlotInfo);
+	void RemoveFromSlotIndex(const FString& SaveGameName);
+
 	template <class TSaveGame>
 	TSaveGame* GetDesiredSaveObject(const FString& FullSavePath, const FSoftClassPath& InClassName, TSaveGame*& SaveGameObject);
 
@@ -223,11 +316,27 @@ public:
 		return UEMSPluginSettings::Get()->MultiLevelSaving == EMultiLevelSaveMethod::ML_Stream;
 	}
 
+	FORCEINLINE bool IsDeltaSave() const
+	{
+		return UEMSPluginSettings::Get()->bDeltaSaving 
+			&& UEMSPluginSettings::Get()->MultiLevelSaving == EMultiLevelSaveMethod::ML_Disabled;
+	}
+
+	FORCEINLINE bool UseAsyncFileWriting() const
+	{
+		return UEMSPluginSettings::Get()->bAsyncFileWriting && FPlatformProcess::SupportsMultithreading();
+	}
+
 	FORCEINLINE bool IsConsoleFileSystem() const
 	{
 		return UEMSPluginSettings::Get()->FileSaveMethod == EFileSaveMethod::FM_Console;
 	}
 
+	FORCEINLINE ESaveCompressionCodec GetCompressionCodec() const
+	{
+		return IsConsoleFileSystem() ? ESaveCompressionCodec::SC_None : UEMSPluginSettings::Get()->CompressionCodec;
+	}
+
 /** File Access and Path Names  */
 
 public:
@@ -242,9 +351,14 @@ public:
 	{
 		CachedSlotInfoSave = nullptr;
 
-		LevelArchiveList.Empty();
+		LevelChunkStack = FLevelChunkArchive();
 		MultiLevelStreamData = FMultiLevelStreamingData();
 		PlayerStackData = FPlayerStackArchive();
+
+		LevelDeltaJournal = FLevelDeltaJournal();
+		LevelDeltaHashes.Empty();
+		bHasLevelDeltaBase = false;
+		LoadedLevelChecksum = 0;
 	}
 
 	FORCEINLINE void ClearCachedCustomSaves()
@@ -252,9 +366,21 @@ public:
 		CachedCustomSaves.Empty();
 	}
 
+	FORCEINLINE FString SaveGameDir() const
+	{
+		//Root folder of the generic save game system.
+		return FPaths::ProjectSavedDir() + TEXT("SaveGames/");
+	}
+
+	FORCEINLINE FString SaveGameFilePath(const FString& FullSavePath) const
+	{
+		//File the generic save game system reads and writes for this save name.
+		return SaveGameDir() + FullSavePath + SaveType;
+	}
+
 	FORCEINLINE FString SaveUserDir() const
 	{
-		return FPaths::ProjectSavedDir() + TEXT("SaveGames/Users/");
+		return SaveGameDir() + TEXT("Users/");
 	}
 
 	FORCEINLINE FString UserSubDir() const
@@ -270,7 +396,7 @@ public:
 			return SaveUserDir() + CurrentSaveUserName + Slash;
 		}
 
-		return FPaths::ProjectSavedDir() + TEXT("SaveGames/");
+		return SaveGameDir();
 	}
 
 	FORCEINLINE FString AllSaveFiles() const
@@ -336,6 +462,11 @@ public:
 		return FullSaveDir(ActorSuffix, SaveGameName);
 	}
 
+	FORCEINLINE FString ActorJournalFile(const FString& SaveGameName = FString()) const
+	{
+		return FullSaveDir(JournalSuffix, SaveGameName);
+	}
+
 	FORCEINLINE FString PlayerSaveFile(const FString& SaveGameName = FString())  const
 	{
 		return FullSaveDir(PlayerSuffix, SaveGameName);
@@ -347,6 +478,16 @@ public:
 		return ThumbnailPath + TEXT("thumb.png");
 	}
 
+	FORCEINLINE FString SlotIndexFile() const
+	{
+		if (!CurrentSaveUserName.IsEmpty())
+		{
+			return UserSubDir() + SlotIndexName;
+		}
+
+		return SlotIndexName;
+	}
+
 	FORCEINLINE FString SlotFilePath(const FString& SaveGameName = FString()) const
 	{
 		//This is only used for sorting.
@@ -387,6 +528,11 @@ public:
 		return ActorName;
 	}
 
+	FORCEINLINE FName GetActorSaveName(const FActorSaveData& ActorArray) const
+	{
+		return ActorArray.Name;
+	}
+
 	FORCEINLINE FString ValidateSaveName(const FString& SaveGameName) const
 	{
 		FString CurrentSave = SaveGameName;
@@ -26,6 +26,10 @@ public:
 	UPROPERTY(config, EditAnywhere, Category = "General Settings", meta = (DisplayName = "File System"))
 	EFileSaveMethod FileSaveMethod = EFileSaveMethod::FM_Desktop;
 
+	/**How many imported thumbnails are kept in memory. The least recently used thumbnail is released first.*/
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "General Settings", meta = (DisplayName = "Thumbnail Cache Size", ClampMin = 0))
+	int ThumbnailCacheSize = 32;
+
 	/**If enabled, the system runs a more expensive check for spawned Actors. This is useful if you spawn Actors at the beginning of a level and experience issues.*/
 	UPROPERTY(config, EditAnywhere, Category = "Actors", meta = (DisplayName = "Advanced Spawn Check"))
 	bool bAdvancedSpawnCheck = false;
@@ -40,6 +44,21 @@ public:
 	UPROPERTY(config, EditAnywhere, Category = "Save and Load", meta = (DisplayName = "Multi-Thread Saving"))
 	bool bMultiThreadSaving = false;
 
+	/**If enabled, the properties of level actors and their components are serialized in parallel. Save interface events are still called in order on the saving thread.*/
+	UPROPERTY(config, EditAnywhere, Category = "Save and Load", meta = (DisplayName = "Parallel Actor Serialization"))
+	bool bParallelSerialization = false;
+
+	/**
+	* The compression format of new save files. Files are always loaded with the format they were saved with.
+	* Not used with the console file system, which does not compress.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Save and Load", meta = (DisplayName = "Compression Format"))
+	ESaveCompressionCodec CompressionCodec = ESaveCompressionCodec::SC_Zlib;
+
+	/**If enabled, save files are compressed and written on a background thread. The game thread only creates the save data.*/
+	UPROPERTY(config, EditAnywhere, Category = "Save and Load", meta = (DisplayName = "Async File Writing"))
+	bool bAsyncFileWriting = false;
+
 	/**The method that is used to load level-actors.*/
 	UPROPERTY(config, EditAnywhere, Category = "Save and Load", meta = (DisplayName = "Level Load Method"))
 	ELoadMethod LoadMethod = ELoadMethod::LM_Default;
@@ -48,6 +67,10 @@ public:
 	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Save and Load", meta = (DisplayName = "Deferred Load Size", EditCondition = "LoadMethod == ELoadMethod::LM_Deferred"))
 	int DeferredLoadStackSize = 15;
 
+	/**Time in milliseconds that loading Actors may take per frame.*/
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Save and Load", meta = (DisplayName = "Load Time Budget", EditCondition = "LoadMethod == ELoadMethod::LM_Budgeted", ClampMin = 0.1, Units = "ms"))
+	float LoadTimeBudget = 4.f;
+
 	/**How long the Async load/wait nodes are allowed to remain fixed in a state.*/
 	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Save and Load", meta = (DisplayName = "Async Wait Delay"))
 	float AsyncWaitDelay = 10.f;
@@ -64,6 +87,18 @@ public:
 	UPROPERTY(config, EditAnywhere, Category = "Save and Load", meta = (DisplayName = "Multi-Level Saving Mode"))
 	EMultiLevelSaveMethod MultiLevelSaving = EMultiLevelSaveMethod::ML_Disabled;
 
+	/**
+	* If enabled, level saves only write Actors that changed since the last save into a small journal file.
+	* The journal is merged back into a full level save after a number of delta saves. 
+	* Only available without Multi-Level Saving.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Save and Load", meta = (DisplayName = "Delta Saving", EditCondition = "MultiLevelSaving == EMultiLevelSaveMethod::ML_Disabled"))
+	bool bDeltaSaving = false;
+
+	/**Number of delta saves after which the journal is compacted into a full level save.*/
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Save and Load", meta = (DisplayName = "Delta Compaction Interval", EditCondition = "bDeltaSaving", ClampMin = 1))
+	int DeltaCompactionInterval = 10;
+
 	/**The controller, pawn and player state can be loaded independent of the level without transforms.*/
 	UPROPERTY(config, EditAnywhere, Category = "Persistence", meta = (DisplayName = "Persistent Player", EditCondition = "MultiLevelSaving == EMultiLevelSaveMethod::ML_Disabled"))
 	bool bPersistentPlayer;
@@ -0,0 +1,21 @@
+//Easy Multi Save - Copyright (C) 2022 by Michael Hegemann.  
+
+using UnrealBuildTool;
+
+public class EasyMultiSaveTests : ModuleRules
+{
+	public EasyMultiSaveTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"EasyMultiSave",
+			}
+			);
+	}
+}
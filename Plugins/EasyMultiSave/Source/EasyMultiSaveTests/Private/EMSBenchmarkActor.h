@@ -0,0 +1,62 @@
+//Easy Multi Save - Copyright (C) 2022 by Michael Hegemann.  
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "EMSActorSaveInterface.h"
+#include "EMSBenchmarkActor.generated.h"
+
+/**
+* Synthetic save Actor, only spawned by the EasyMultiSave benchmarks.
+*/
+UCLASS(NotBlueprintable, NotPlaceable, HideDropdown)
+class AEMSBenchmarkActor : public AActor, public IEMSActorSaveInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	AEMSBenchmarkActor()
+	{
+		RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+		SavedValue = 0;
+	}
+
+	UPROPERTY(SaveGame)
+	int32 SavedValue;
+
+	UPROPERTY(SaveGame)
+	FString SavedText;
+
+	UPROPERTY(Transient)
+	TArray<UActorComponent*> SavedComponents;
+
+	//Saved components each new benchmark Actor gets, also applies to Actors spawned while loading.
+	static int32& ComponentNum()
+	{
+		static int32 Num = 0;
+		return Num;
+	}
+
+	virtual void OnConstruction(const FTransform& Transform) override
+	{
+		Super::OnConstruction(Transform);
+
+		for (int32 Index = SavedComponents.Num(); Index < ComponentNum(); ++Index)
+		{
+			USceneComponent* Component = NewObject<USceneComponent>(this, *FString::Printf(TEXT("BenchmarkComponent_%d"), Index));
+			Component->SetupAttachment(RootComponent);
+			Component->SetRelativeLocation(FVector(0.f, 0.f, Index * 10.f));
+			Component->RegisterComponent();
+
+			SavedComponents.Add(Component);
+		}
+	}
+
+	virtual void ComponentsToSave_Implementation(TArray<UActorComponent*>& Components) override
+	{
+		Components = SavedComponents;
+	}
+};
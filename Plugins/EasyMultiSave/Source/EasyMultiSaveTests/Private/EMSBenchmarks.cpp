@@ -0,0 +1,260 @@
+//Easy Multi Save - Copyright (C) 2022 by Michael Hegemann.  
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "EMSObject.h"
+#include "EMSBenchmarkActor.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+/**
+Benchmarks, run headless with:
+-ExecCmds="Automation RunTests EasyMultiSave.Benchmark; Quit" -nullrhi -unattended
+**/
+
+namespace EMSBenchmark
+{
+	static const FString SlotName(TEXT("EMSBenchmark"));
+
+	//Comma separated counts from the command line, e.g. -EMSBenchmarkActors=1000,20000
+	static TArray<int32> GetCounts(const TCHAR* Switch, const TArray<int32>& Defaults)
+	{
+		FString Value;
+		if (!FParse::Value(FCommandLine::Get(), Switch, Value, false))
+		{
+			return Defaults;
+		}
+
+		TArray<FString> Entries;
+		Value.ParseIntoArray(Entries, TEXT(","));
+
+		TArray<int32> Counts;
+		for (const FString& Entry : Entries)
+		{
+			const int32 Count = FCString::Atoi(*Entry);
+			if (Count > 0)
+			{
+				Counts.Add(Count);
+			}
+		}
+
+		return Counts.Num() > 0 ? Counts : Defaults;
+	}
+
+	//Standalone game world with its own Easy Multi Save subsystem. The save files of the benchmark slot are removed afterwards.
+	struct FBenchmarkWorld
+	{
+		UGameInstance* GameInstance;
+		UEMSObject* EMS;
+		FString PreviousSaveGameName;
+		TArray<AEMSBenchmarkActor*> Actors;
+
+		explicit FBenchmarkWorld(const int32 ComponentNum = 0)
+			: EMS(nullptr)
+		{
+			AEMSBenchmarkActor::ComponentNum() = ComponentNum;
+
+			GameInstance = NewObject<UGameInstance>(GEngine);
+			GameInstance->AddToRoot();
+			GameInstance->InitializeStandalone(TEXT("EMSBenchmark"));
+
+			EMS = GameInstance->GetSubsystem<UEMSObject>();
+			if (EMS)
+			{
+				PreviousSaveGameName = EMS->CurrentSaveGameName;
+				EMS->SetCurrentSaveGameName(SlotName);
+			}
+		}
+
+		~FBenchmarkWorld()
+		{
+			if (EMS)
+			{
+				EMS->DeleteAllSaveDataForSlot(SlotName);
+				EMS->SetCurrentSaveGameName(PreviousSaveGameName);
+			}
+
+			UWorld* World = GetWorld();
+			GameInstance->Shutdown();
+
+			if (World)
+			{
+				GEngine->DestroyWorldContext(World);
+				World->DestroyWorld(false);
+			}
+
+			GameInstance->RemoveFromRoot();
+			AEMSBenchmarkActor::ComponentNum() = 0;
+		}
+
+		UWorld* GetWorld() const
+		{
+			return GameInstance->GetWorld();
+		}
+
+		bool IsValid() const
+		{
+			return EMS && GetWorld();
+		}
+
+		void SpawnActors(const int32 ActorNum)
+		{
+			for (int32 Index = 0; Index < ActorNum; ++Index)
+			{
+				FActorSpawnParameters SpawnParams;
+				SpawnParams.Name = FName(*FString::Printf(TEXT("EMSBenchmarkActor_%d"), Index));
+				SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+				const FVector Location(Index % 100 * 100.f, Index / 100 * 100.f, 0.f);
+
+				AEMSBenchmarkActor* Actor = GetWorld()->SpawnActor<AEMSBenchmarkActor>(Location, FRotator::ZeroRotator, SpawnParams);
+				if (Actor)
+				{
+					Actor->SavedValue = Index;
+					Actor->SavedText = Actor->GetName();
+					Actors.Add(Actor);
+				}
+			}
+		}
+
+		void DestroyActors()
+		{
+			for (AEMSBenchmarkActor* Actor : Actors)
+			{
+				if (::IsValid(Actor))
+				{
+					Actor->Destroy();
+				}
+			}
+
+			Actors.Empty();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+
+		//Returns the seconds spent until the level file is written.
+		double SaveLevel()
+		{
+			const double StartTime = FPlatformTime::Seconds();
+
+			EMS->PrepareLoadAndSaveActors(ENUM_TO_FLAG(ESaveTypeFlags::SF_Level));
+			EMS->SaveLevelActors();
+			EMS->WaitForPendingWrites();
+
+			return FPlatformTime::Seconds() - StartTime;
+		}
+
+		//Returns the seconds spent until all saved Actors are updated or spawned, or a negative value if the file could not be read.
+		double LoadLevel()
+		{
+			const double StartTime = FPlatformTime::Seconds();
+
+			EMS->PrepareLoadAndSaveActors(ENUM_TO_FLAG(ELoadTypeFlags::LF_Level), true);
+			if (!EMS->TryLoadLevelFile())
+			{
+				return -1.0;
+			}
+
+			for (const FActorSaveData& ActorArray : EMS->SavedActors)
+			{
+				EMS->SpawnOrUpdateLevelActor(ActorArray);
+			}
+
+			return FPlatformTime::Seconds() - StartTime;
+		}
+	};
+}
+
+/**
+Actor Lookup
+**/
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEMSBenchmarkActorLookup, "EasyMultiSave.Benchmark.ActorLookup", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FEMSBenchmarkActorLookup::RunTest(const FString& Parameters)
+{
+	//Loading into a world that already has all saved Actors, so each record is resolved through the name lookup.
+	const TArray<int32> ActorCounts = EMSBenchmark::GetCounts(TEXT("EMSBenchmarkActors="), { 1000, 5000, 20000 });
+
+	for (const int32 ActorNum : ActorCounts)
+	{
+		EMSBenchmark::FBenchmarkWorld Benchmark;
+		if (!TestTrue(TEXT("Benchmark world created"), Benchmark.IsValid()))
+		{
+			return false;
+		}
+
+		Benchmark.SpawnActors(ActorNum);
+		Benchmark.SaveLevel();
+
+		const double LoadTime = Benchmark.LoadLevel();
+		if (!TestTrue(TEXT("Level file loaded"), LoadTime >= 0.0))
+		{
+			return false;
+		}
+
+		TestEqual(TEXT("Updated Actors"), Benchmark.EMS->OperationCounters.ActorsUpdated, ActorNum);
+
+		AddInfo(FString::Printf(TEXT("%d Actors: load %.2f ms, %.3f us per Actor"), ActorNum, LoadTime * 1000.0, LoadTime * 1000000.0 / ActorNum));
+
+		Benchmark.DestroyActors();
+	}
+
+	return true;
+}
+
+/**
+Save and Load
+**/
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEMSBenchmarkSaveLoad, "EasyMultiSave.Benchmark.SaveLoad", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FEMSBenchmarkSaveLoad::RunTest(const FString& Parameters)
+{
+	//Saves a synthetic world, then loads it once into the existing Actors and once into an empty world.
+	const TArray<int32> ActorCounts = EMSBenchmark::GetCounts(TEXT("EMSBenchmarkActors="), { 1000, 10000 });
+	const TArray<int32> ComponentCounts = EMSBenchmark::GetCounts(TEXT("EMSBenchmarkComponents="), { 1, 8 });
+
+	for (const int32 ActorNum : ActorCounts)
+	{
+		for (const int32 ComponentNum : ComponentCounts)
+		{
+			EMSBenchmark::FBenchmarkWorld Benchmark(ComponentNum);
+			if (!TestTrue(TEXT("Benchmark world created"), Benchmark.IsValid()))
+			{
+				return false;
+			}
+
+			Benchmark.SpawnActors(ActorNum);
+
+			const double SaveTime = Benchmark.SaveLevel();
+			const FOperationCounters SaveCounters = Benchmark.EMS->OperationCounters;
+			TestEqual(TEXT("Saved Actors"), SaveCounters.ActorsSaved, ActorNum);
+
+			const double UpdateTime = Benchmark.LoadLevel();
+			TestEqual(TEXT("Updated Actors"), Benchmark.EMS->OperationCounters.ActorsUpdated, ActorNum);
+
+			Benchmark.DestroyActors();
+
+			const double SpawnTime = Benchmark.LoadLevel();
+			TestEqual(TEXT("Spawned Actors"), Benchmark.EMS->OperationCounters.ActorsSpawned, ActorNum);
+
+			if (!TestTrue(TEXT("Level file loaded"), UpdateTime >= 0.0 && SpawnTime >= 0.0))
+			{
+				return false;
+			}
+
+			AddInfo(FString::Printf(TEXT("%d Actors, %d Components: save %.2f ms (%lld bytes, %lld compressed), load into existing %.2f ms, load with spawn %.2f ms"),
+				ActorNum, ComponentNum, SaveTime * 1000.0, SaveCounters.ArchiveBytes, SaveCounters.CompressedBytes, UpdateTime * 1000.0, SpawnTime * 1000.0));
+		}
+	}
+
+	return true;
+}
+
+#endif
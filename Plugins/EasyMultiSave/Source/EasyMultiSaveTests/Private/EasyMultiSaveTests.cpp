@@ -0,0 +1,7 @@
+//Easy Multi Save - Copyright (C) 2022 by Michael Hegemann.  
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+//Automation tests and benchmarks, not part of Shipping builds.
+IMPLEMENT_MODULE(FDefaultModuleImpl, EasyMultiSaveTests)
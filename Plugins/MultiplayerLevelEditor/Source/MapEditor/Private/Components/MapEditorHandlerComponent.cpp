@@ -4,11 +4,16 @@
 #include "Components/MapEditorHandlerComponent.h"
 #include "MapEditorGizmo.h"
 #include "MapEditorInterface.h"
+#include "MapEditorStatics.h"
 
 #include "DrawDebugHelpers.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerController.h"
 #include "Net/UnrealNetwork.h"
+#include "MapEditorSubsystem.h"
+#include "TimerManager.h"
+
+const int32 UMapEditorHandlerComponent::MaxActorsPerRequest = 1000;
 
 UMapEditorHandlerComponent::UMapEditorHandlerComponent()
 {
@@ -19,6 +24,17 @@ UMapEditorHandlerComponent::UMapEditorHandlerComponent()
 	MapDirectory = FString("Maps");
 
 	ReplicationRate = 1.0f;
+
+	MinReplicatedDelta.Location = 0.5f;
+	MinReplicatedDelta.Rotation = 0.5f;
+	MinReplicatedDelta.Scale = 0.01f;
+	LastTransformFlushTime = -1.0f;
+	bGroupDeltaPending = false;
+	bGroupEditActive = false;
+
+	MaxUndoSteps = 100;
+	UndoCommandId = INDEX_NONE;
+	RedoCommandId = INDEX_NONE;
 }
 
 
@@ -27,9 +43,22 @@ void UMapEditorHandlerComponent::OnRep_CurrentActor()
 	SetActor(CurrentActor);
 }
 
+void UMapEditorHandlerComponent::OnRep_DuplicatedActors()
+{
+	SelectActors(DuplicatedActors);
+}
+
 void UMapEditorHandlerComponent::BeginPlay()
 {
 	Super::BeginPlay();
+	Journal.SetCapacity(MaxUndoSteps);
+	if (GetOwnerRole() == ENetRole::ROLE_Authority)
+	{
+		if (UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>())
+		{
+			Subsystem->OnMapReset.AddUObject(this, &UMapEditorHandlerComponent::ResetJournal);
+		}
+	}
 	if (APawn* OwningPawn = GetOwner<APawn>())
 	{
 		if (OwningPawn->IsLocallyControlled() && GizmoClass)
@@ -44,6 +73,9 @@ void UMapEditorHandlerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProp
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 	DOREPLIFETIME_CONDITION(UMapEditorHandlerComponent, CurrentActor, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(UMapEditorHandlerComponent, UndoCommandId, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(UMapEditorHandlerComponent, RedoCommandId, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(UMapEditorHandlerComponent, DuplicatedActors, COND_OwnerOnly);
 }
 
 FHitResult UMapEditorHandlerComponent::MouseTraceSingle(const float Distance, bool& bHitGizmo, const ECollisionChannel CollisionChannel, const bool bDrawDebugLine)
@@ -181,17 +213,217 @@ void UMapEditorHandlerComponent::SetGizmo()
 	}
 }
 
-bool UMapEditorHandlerComponent::Server_ReplicateTransform_Validate(AActor* Actor, FTransform Transform)
+bool UMapEditorHandlerComponent::Server_ReplicateNetTransform_Validate(AActor* Actor, FMapEditorNetTransform Transform)
 {
 	return true;
 }
 
-void UMapEditorHandlerComponent::Server_ReplicateTransform_Implementation(AActor* Actor, FTransform Transform)
+void UMapEditorHandlerComponent::Server_ReplicateNetTransform_Implementation(AActor* Actor, FMapEditorNetTransform Transform)
 {
-	if (Actor)
+	// Dropped updates are covered by the reliable commit at the end of the drag
+	if (IsEditableActor(Actor) && AllowTransformUpdate())
+	{
+		BeginEdit(Actor);
+		Actor->SetActorTransform(ClampToEditLimits(Transform.ToTransform()));
+	}
+}
+
+bool UMapEditorHandlerComponent::Server_CommitTransform_Validate(AActor* Actor, FMapEditorNetTransform Transform)
+{
+	return true;
+}
+
+void UMapEditorHandlerComponent::Server_CommitTransform_Implementation(AActor* Actor, FMapEditorNetTransform Transform)
+{
+	if (!IsEditableActor(Actor)) return;
+
+	// A limited commit still closes the edit the accepted updates opened
+	if (AllowCommit())
+	{
+		BeginEdit(Actor);
+		Actor->SetActorTransform(ClampToEditLimits(Transform.ToTransform()));
+	}
+	else
+	{
+		CorrectTransforms(TArray<AActor*>({ Actor }));
+	}
+	EndEdit(Actor);
+}
+
+FMapEditorSnapping UMapEditorHandlerComponent::GetReplicationTolerance() const
+{
+	FMapEditorSnapping Tolerance;
+	Tolerance.Location = FMath::Max(MinReplicatedDelta.Location, SnapAmount.Location * 0.5f);
+	Tolerance.Rotation = FMath::Max(MinReplicatedDelta.Rotation, SnapAmount.Rotation * 0.5f);
+	Tolerance.Scale = FMath::Max(MinReplicatedDelta.Scale, SnapAmount.Scale * 0.5f);
+	return Tolerance;
+}
+
+void UMapEditorHandlerComponent::QueueTransform(AActor* Actor)
+{
+	if (!Actor) return;
+	
+	const FMapEditorNetTransform NetTransform(Actor->GetActorTransform());
+	const FMapEditorNetTransform* SentTransform = SentTransforms.Find(Actor);
+	if (SentTransform && SentTransform->Equals(NetTransform, GetReplicationTolerance()))
+	{
+		PendingTransforms.Remove(Actor);
+		return;
+	}
+	PendingTransforms.Add(Actor, NetTransform);
+	ScheduleTransformFlush();
+}
+
+void UMapEditorHandlerComponent::ScheduleTransformFlush()
+{
+	// Updates within one replication interval replace each other
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if (!TimerManager.IsTimerActive(TFlushTransformsHandle))
+	{
+		const float TimeSinceFlush = GetWorld()->GetTimeSeconds() - LastTransformFlushTime;
+		const float Delay = GetReplicationRate() - TimeSinceFlush;
+		if (LastTransformFlushTime < 0.0f || Delay <= 0.0f)
+		{
+			FlushTransforms();
+		}
+		else
+		{
+			TimerManager.SetTimer(TFlushTransformsHandle, this, &UMapEditorHandlerComponent::FlushTransforms, Delay, false);
+		}
+	}
+}
+
+void UMapEditorHandlerComponent::FlushTransforms()
+{
+	LastTransformFlushTime = GetWorld()->GetTimeSeconds();
+	for (TPair<TWeakObjectPtr<AActor>, FMapEditorNetTransform>& Pending : PendingTransforms)
+	{
+		if (AActor* Actor = Pending.Key.Get())
+		{
+			Server_ReplicateNetTransform(Actor, Pending.Value);
+			SentTransforms.Add(Actor, Pending.Value);
+		}
+	}
+	PendingTransforms.Reset();
+
+	if (bGroupDeltaPending)
+	{
+		bGroupDeltaPending = false;
+		Server_ReplicateGroupDelta(SelectedActors, GroupDelta);
+	}
+}
+
+bool UMapEditorHandlerComponent::Server_ReplicateGroupDelta_Validate(const TArray<AActor*>& Actors, FMapEditorGroupDelta Delta)
+{
+	return Actors.Num() <= MaxActorsPerRequest && !Delta.Rotation.ContainsNaN();
+}
+
+void UMapEditorHandlerComponent::Server_ReplicateGroupDelta_Implementation(const TArray<AActor*>& Actors, FMapEditorGroupDelta Delta)
+{
+	if (!AllowTransformUpdate(Actors.Num())) return;
+	
+	TArray<AActor*> EditableActors;
+	FilterEditableActors(Actors, EditableActors);
+	ApplyGroupDelta(EditableActors, Delta);
+}
+
+bool UMapEditorHandlerComponent::Server_CommitGroupDelta_Validate(const TArray<AActor*>& Actors, FMapEditorGroupDelta Delta)
+{
+	return Actors.Num() <= MaxActorsPerRequest && !Delta.Rotation.ContainsNaN();
+}
+
+void UMapEditorHandlerComponent::Server_CommitGroupDelta_Implementation(const TArray<AActor*>& Actors, FMapEditorGroupDelta Delta)
+{
+	TArray<AActor*> EditableActors;
+	FilterEditableActors(Actors, EditableActors);
+	if (AllowCommit(EditableActors.Num()))
+	{
+		ApplyGroupDelta(EditableActors, Delta);
+	}
+	else
+	{
+		CorrectTransforms(EditableActors);
+	}
+	EndEdits(EditableActors);
+}
+
+void UMapEditorHandlerComponent::CorrectTransforms(const TArray<AActor*>& Actors)
+{
+	TArray<FMapEditorNetTransform> Transforms;
+	Transforms.Reserve(Actors.Num());
+	for (const AActor* Actor : Actors)
 	{
-		Actor->SetActorTransform(Transform);
+		Transforms.Add(FMapEditorNetTransform(Actor->GetActorTransform()));
 	}
+	Client_CorrectTransforms(Actors, Transforms);
+}
+
+void UMapEditorHandlerComponent::Client_CorrectTransforms_Implementation(const TArray<AActor*>& Actors, const TArray<FMapEditorNetTransform>& Transforms)
+{
+	for (int32 Index = 0; Index < Actors.Num() && Index < Transforms.Num(); ++Index)
+	{
+		if (AActor* Actor = Actors[Index])
+		{
+			PendingTransforms.Remove(Actor);
+			SentTransforms.Remove(Actor);
+			Actor->SetActorTransform(Transforms[Index].ToTransform());
+		}
+	}
+	SnapGizmo();
+}
+
+void UMapEditorHandlerComponent::ApplyGroupDelta(const TArray<AActor*>& Actors, const FMapEditorGroupDelta& Delta)
+{
+	// The delta is always applied to where each actor was when the edit started, so lost updates do not add up
+	for (AActor* Actor : Actors)
+	{
+		if (IsValid(Actor))
+		{
+			BeginEdit(Actor);
+			Actor->SetActorTransform(ClampToEditLimits(Delta.Apply(EditStartTransforms.FindChecked(Actor).ToTransform())));
+		}
+	}
+}
+
+void UMapEditorHandlerComponent::BeginGroupEdit()
+{
+	GroupDelta.Reset(GetSelectionPivot());
+	bGroupDeltaPending = false;
+	bGroupEditActive = SelectedActors.Num() > 1;
+	for (AActor* Actor : SelectedActors)
+	{
+		BeginEdit(Actor);
+	}
+}
+
+void UMapEditorHandlerComponent::CommitGroupEdit()
+{
+	bGroupEditActive = false;
+	bGroupDeltaPending = false;
+	if (HasAuthority())
+	{
+		EndEdits(SelectedActors);
+	}
+	else
+	{
+		Server_CommitGroupDelta(SelectedActors, GroupDelta);
+	}
+	GroupDelta.Reset(GetSelectionPivot());
+}
+
+void UMapEditorHandlerComponent::CommitTransform(AActor* Actor)
+{
+	if (!Actor) return;
+	if (HasAuthority())
+	{
+		EndEdit(Actor);
+		return;
+	}
+
+	// The final transform of a drag is always sent, and reliably
+	PendingTransforms.Remove(Actor);
+	SentTransforms.Remove(Actor);
+	Server_CommitTransform(Actor, FMapEditorNetTransform(Actor->GetActorTransform()));
 }
 
 void UMapEditorHandlerComponent::SetActor(AActor* Actor)
@@ -209,19 +441,25 @@ void UMapEditorHandlerComponent::SetActor(AActor* Actor)
 	}
 	
 	CurrentActor = Actor;
-
+	SelectedActors.Reset();
 	if (CurrentActor)
 	{
-		FMapEditorSteps UndoStep;
-		UndoStep.Actor = CurrentActor;
-		UndoSteps.Add(UndoStep);
+		SelectedActors.Add(CurrentActor);
 	}
-	
+	SnapGizmo();
+}
+
+void UMapEditorHandlerComponent::SnapGizmo()
+{
 	if (Gizmo.IsValid())
 	{
 		if (CurrentActor)
 		{
 			Gizmo->SnapToActor(CurrentActor);
+			if (SelectedActors.Num() > 1)
+			{
+				Gizmo->SetActorLocation(GetSelectionPivot());
+			}
 			Gizmo->HideGizmo(false);
 		}
 		else
@@ -232,9 +470,176 @@ void UMapEditorHandlerComponent::SetActor(AActor* Actor)
 	}
 }
 
+void UMapEditorHandlerComponent::AddToSelection(AActor* Actor)
+{
+	if (!Actor || !Actor->IsRootComponentMovable()) return;
+	if (!CurrentActor)
+	{
+		SetActor(Actor);
+		return;
+	}
+	if (SelectedActors.Contains(Actor) || SelectedActors.Num() >= MaxActorsPerRequest) return;
+	
+	if (Actor->Implements<UMapEditorInterface>())
+	{
+		IMapEditorInterface::Execute_OnGrabbed(Actor);
+	}
+	SelectedActors.Add(Actor);
+	CurrentActor = Actor;
+	SnapGizmo();
+}
+
+void UMapEditorHandlerComponent::RemoveFromSelection(AActor* Actor)
+{
+	if (SelectedActors.Remove(Actor))
+	{
+		if (CurrentActor == Actor)
+		{
+			CurrentActor = SelectedActors.Num() ? SelectedActors.Last() : nullptr;
+		}
+		SnapGizmo();
+	}
+}
+
+void UMapEditorHandlerComponent::SelectActors(const TArray<AActor*>& Actors)
+{
+	ClearSelection();
+	for (AActor* Actor : Actors)
+	{
+		AddToSelection(Actor);
+	}
+}
+
+void UMapEditorHandlerComponent::ClearSelection()
+{
+	SelectedActors.Reset();
+	CurrentActor = nullptr;
+	SnapGizmo();
+}
+
+void UMapEditorHandlerComponent::BoxSelect(FVector2D ScreenStart, FVector2D ScreenEnd, bool bAddToSelection, float Distance)
+{
+	APlayerController* PC = UGameplayStatics::GetPlayerController(GetWorld(), 0);
+	if (!PC) return;
+
+	if (!bAddToSelection)
+	{
+		ClearSelection();
+	}
+	
+	UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>();
+	if (!Subsystem) return;
+	
+	const FBox2D ScreenBox(FVector2D::Min(ScreenStart, ScreenEnd), FVector2D::Max(ScreenStart, ScreenEnd));
+
+	// Only the grid cells around the selection frustum are queried, then each candidate is projected
+	FBox FrustumBounds(ForceInit);
+	const FVector2D Corners[] = { ScreenBox.Min, FVector2D(ScreenBox.Max.X, ScreenBox.Min.Y), ScreenBox.Max, FVector2D(ScreenBox.Min.X, ScreenBox.Max.Y) };
+	for (const FVector2D& Corner : Corners)
+	{
+		FVector WorldLocation;
+		FVector WorldDirection;
+		if (!PC->DeprojectScreenPositionToWorld(Corner.X, Corner.Y, WorldLocation, WorldDirection)) return;
+		FrustumBounds += WorldLocation;
+		FrustumBounds += WorldLocation + WorldDirection * Distance;
+	}
+	
+	TArray<AActor*> Actors;
+	Subsystem->GetActorsInBox(FrustumBounds, Actors);
+	for (AActor* Actor : Actors)
+	{
+		FVector2D ScreenLocation;
+		if (PC->ProjectWorldLocationToScreen(Actor->GetActorLocation(), ScreenLocation)
+			&& ScreenBox.IsInside(ScreenLocation))
+		{
+			AddToSelection(Actor);
+		}
+	}
+}
+
+FVector UMapEditorHandlerComponent::GetSelectionPivot() const
+{
+	FBox Bounds(ForceInit);
+	for (const AActor* Actor : SelectedActors)
+	{
+		if (IsValid(Actor))
+		{
+			Bounds += Actor->GetActorLocation();
+		}
+	}
+	return Bounds.IsValid ? Bounds.GetCenter() : FVector::ZeroVector;
+}
+
+void UMapEditorHandlerComponent::MoveSelection(const FVector& Offset)
+{
+	for (AActor* Actor : SelectedActors)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->AddActorWorldOffset(Offset);
+		}
+	}
+	GroupDelta.Offset += Offset;
+}
+
+void UMapEditorHandlerComponent::RotateSelection(const FRotator& Rotation)
+{
+	const FQuat DeltaRotation = Rotation.Quaternion();
+	const FVector Pivot = GroupDelta.Pivot;
+	for (AActor* Actor : SelectedActors)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->SetActorLocation(Pivot + DeltaRotation.RotateVector(Actor->GetActorLocation() - Pivot));
+			Actor->AddActorWorldRotation(DeltaRotation);
+		}
+	}
+	GroupDelta.Rotation = DeltaRotation * GroupDelta.Rotation;
+}
+
+void UMapEditorHandlerComponent::ScaleSelection(const FVector& ScaleDelta)
+{
+	for (AActor* Actor : SelectedActors)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->SetActorScale3D(FMapEditorGroupDelta::ClampScale(Actor->GetActorScale3D() + ScaleDelta));
+		}
+	}
+	GroupDelta.Scale += ScaleDelta;
+}
+
 FHitResult UMapEditorHandlerComponent::MouseTrace(float Distance, bool& bHitGizmo, bool bDrawDebugLine)
 {
-	return MouseTraceMulti(Distance, bHitGizmo, TraceCollisionChannel, bDrawDebugLine);
+	UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>();
+	APlayerController* PC = UGameplayStatics::GetPlayerController(GetWorld(), 0);
+	FVector WorldLocation;
+	FVector WorldDirection;
+	if (!Subsystem || !PC || !PC->DeprojectMousePositionToWorld(WorldLocation, WorldDirection))
+	{
+		return MouseTraceMulti(Distance, bHitGizmo, TraceCollisionChannel, bDrawDebugLine);
+	}
+
+	// Only the gizmo and the indexed editable actors are traced, not the whole physics scene
+	const FVector End = WorldLocation + WorldDirection * Distance;
+	FHitResult HitResult;
+	if (Gizmo.IsValid() && !Gizmo->IsHidden())
+	{
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(MapEditorGizmoTrace), true);
+		if (Gizmo->ActorLineTraceSingle(HitResult, WorldLocation, End, TraceCollisionChannel, Params))
+		{
+			bHitGizmo = true;
+			return HitResult;
+		}
+	}
+	
+	if (bDrawDebugLine)
+	{
+		DrawDebugLine(GetWorld(), WorldLocation, End, FColor::Red, false, 5.0f, 0, 3.0f);
+	}
+	
+	Subsystem->PickActor(WorldLocation, End, TraceCollisionChannel, HitResult, GetOwner());
+	return HitResult;
 }
 
 void UMapEditorHandlerComponent::Grab()
@@ -244,6 +649,7 @@ void UMapEditorHandlerComponent::Grab()
 
 	if (bHitGizmo && Gizmo.IsValid())
 	{
+		BeginGroupEdit();
 		Gizmo->HitGizmo(HitResult);
 	}
 	else
@@ -252,6 +658,29 @@ void UMapEditorHandlerComponent::Grab()
 	}
 }
 
+void UMapEditorHandlerComponent::GrabMulti()
+{
+	bool bHitGizmo = false;
+	FHitResult HitResult = MouseTrace(100000.0f, bHitGizmo, false);
+
+	if (bHitGizmo && Gizmo.IsValid())
+	{
+		BeginGroupEdit();
+		Gizmo->HitGizmo(HitResult);
+	}
+	else if (AActor* Actor = HitResult.GetActor())
+	{
+		if (SelectedActors.Contains(Actor))
+		{
+			RemoveFromSelection(Actor);
+		}
+		else
+		{
+			AddToSelection(Actor);
+		}
+	}
+}
+
 void UMapEditorHandlerComponent::Release()
 {
 	if (Gizmo.IsValid())
@@ -259,14 +688,20 @@ void UMapEditorHandlerComponent::Release()
 		Gizmo->ReleaseGizmo();
 		if (CurrentActor)
 		{
-			if (CurrentActor->Implements<UMapEditorInterface>())
+			for (AActor* Actor : SelectedActors)
 			{
-				IMapEditorInterface::Execute_OnRelease(CurrentActor);
+				if (IsValid(Actor) && Actor->Implements<UMapEditorInterface>())
+				{
+					IMapEditorInterface::Execute_OnRelease(Actor);
+				}
 			}
-			int32 Index = UndoSteps.Num() - 1;
-			if (Index >= 0)
+			if (bGroupEditActive)
 			{
-				UndoSteps[Index].Transforms.Add(CurrentActor->GetActorTransform());
+				CommitGroupEdit();
+			}
+			else
+			{
+				CommitTransform(CurrentActor);
 			}
 		}
 	}
@@ -274,6 +709,17 @@ void UMapEditorHandlerComponent::Release()
 
 void UMapEditorHandlerComponent::ReplicateActor()
 {
+	// Group drags send the selection and one delta instead of a transform per actor
+	if (bGroupEditActive)
+	{
+		if (!HasAuthority())
+		{
+			bGroupDeltaPending = true;
+			ScheduleTransformFlush();
+		}
+		return;
+	}
+	
 	if (CurrentActor)
 	{
 		if (!CurrentActor->GetActorTransform().Equals(CurrentActorTransform))
@@ -281,7 +727,7 @@ void UMapEditorHandlerComponent::ReplicateActor()
 			CurrentActorTransform = CurrentActor->GetActorTransform();
 			if (!HasAuthority())
 			{
-				Server_ReplicateTransform(CurrentActor, CurrentActor->GetActorTransform());
+				QueueTransform(CurrentActor);
 			}
 			else
 			{
@@ -322,12 +768,14 @@ void UMapEditorHandlerComponent::SetActorTransform(const FTransform NewTransform
 {
 	if (CurrentActor)
 	{
+		BeginEdit(CurrentActor);
 		CurrentActor->SetActorTransform(NewTransform);
 		if (Gizmo.IsValid())
 		{
 			Gizmo->SnapToActor(CurrentActor);
 		}
 		ReplicateActor();
+		CommitTransform(CurrentActor);
 	}
 }
 
@@ -340,13 +788,28 @@ void UMapEditorHandlerComponent::DuplicateActor(bool bSpawnInPlace)
 
 		if (!HitResult.Location.Equals(FVector::ZeroVector))
 		{
-			if (bSpawnInPlace)
+			if (SelectedActors.Num() > 1)
+			{
+				const FVector Offset = bSpawnInPlace ? FVector::ZeroVector : HitResult.Location - GetSelectionPivot();
+				if (HasAuthority())
+				{
+					Server_DuplicateActors_Implementation(SelectedActors, Offset);
+				}
+				else
+				{
+					Server_DuplicateActors(SelectedActors, Offset);
+				}
+				return;
+			}
+			
+			const FTransform SpawnTransform = bSpawnInPlace ? CurrentActor->GetTransform() : FTransform(HitResult.Location);
+			if (HasAuthority())
 			{
-				SpawnActorAtTransform(CurrentActor->GetClass(), CurrentActor->GetTransform());
+				Server_DuplicateActor_Implementation(CurrentActor->GetClass(), SpawnTransform);
 			}
 			else
 			{
-				SpawnActorAtTransform(CurrentActor->GetClass(), FTransform(HitResult.Location));
+				Server_DuplicateActor(CurrentActor->GetClass(), SpawnTransform);
 			}
 		}
 	}
@@ -354,71 +817,315 @@ void UMapEditorHandlerComponent::DuplicateActor(bool bSpawnInPlace)
 
 void UMapEditorHandlerComponent::DeselectActor()
 {
-	CurrentActor = nullptr;
+	ClearSelection();
 }
 
 void UMapEditorHandlerComponent::DeleteActor()
 {
 	if (CurrentActor)
 	{
-		if (CurrentActor->Implements<UMapEditorInterface>())
+		for (AActor* Actor : SelectedActors)
 		{
-			IMapEditorInterface::Execute_OnGrabbed(CurrentActor);
+			if (IsValid(Actor) && Actor->Implements<UMapEditorInterface>())
+			{
+				IMapEditorInterface::Execute_OnGrabbed(Actor);
+			}
 		}
 		if (HasAuthority())
 		{
-			CurrentActor->Destroy();
+			DeleteActorsInternal(TArray<AActor*>(SelectedActors));
+		}
+		else if (SelectedActors.Num() > 1)
+		{
+			Server_DeleteActors(SelectedActors);
 		}
 		else
 		{
 			Server_DeleteActor(CurrentActor);
 		}
-		if (Gizmo.IsValid())
+		ClearSelection();
+	}
+}
+
+void UMapEditorHandlerComponent::Undo()
+{
+	if (HasAuthority())
+	{
+		ExecuteUndo(UndoCommandId);
+	}
+	else if (CanUndo())
+	{
+		Server_Undo(UndoCommandId);
+	}
+}
+
+void UMapEditorHandlerComponent::Redo()
+{
+	if (HasAuthority())
+	{
+		ExecuteRedo(RedoCommandId);
+	}
+	else if (CanRedo())
+	{
+		Server_Redo(RedoCommandId);
+	}
+}
+
+bool UMapEditorHandlerComponent::Server_Undo_Validate(int32 CommandId)
+{
+	return true;
+}
+
+void UMapEditorHandlerComponent::Server_Undo_Implementation(int32 CommandId)
+{
+	if (AllowUndo())
+	{
+		ExecuteUndo(CommandId);
+	}
+}
+
+bool UMapEditorHandlerComponent::Server_Redo_Validate(int32 CommandId)
+{
+	return true;
+}
+
+void UMapEditorHandlerComponent::Server_Redo_Implementation(int32 CommandId)
+{
+	if (AllowUndo())
+	{
+		ExecuteRedo(CommandId);
+	}
+}
+
+void UMapEditorHandlerComponent::ExecuteUndo(int32 CommandId)
+{
+	// The id must match, so a repeated request does not undo twice
+	FMapEditorCommand* Command = Journal.PeekUndo();
+	if (Command && Command->Id == CommandId && ApplyCommand(*Command, true))
+	{
+		Journal.PopUndo();
+		UpdateJournalIds();
+	}
+}
+
+void UMapEditorHandlerComponent::ExecuteRedo(int32 CommandId)
+{
+	FMapEditorCommand* Command = Journal.PeekRedo();
+	if (Command && Command->Id == CommandId && ApplyCommand(*Command, false))
+	{
+		Journal.PopRedo();
+		UpdateJournalIds();
+	}
+}
+
+void UMapEditorHandlerComponent::UpdateJournalIds()
+{
+	const FMapEditorCommand* NextUndo = Journal.PeekUndo();
+	const FMapEditorCommand* NextRedo = Journal.PeekRedo();
+	UndoCommandId = NextUndo ? NextUndo->Id : INDEX_NONE;
+	RedoCommandId = NextRedo ? NextRedo->Id : INDEX_NONE;
+}
+
+void UMapEditorHandlerComponent::ResetJournal()
+{
+	// Ids keep counting up so an undo the client sent before the reset can't match a new command
+	Journal.SetCapacity(MaxUndoSteps);
+	EditStartTransforms.Empty();
+	UpdateJournalIds();
+}
+
+void UMapEditorHandlerComponent::BeginEdit(AActor* Actor)
+{
+	if (Actor && HasAuthority() && !EditStartTransforms.Contains(Actor))
+	{
+		EditStartTransforms.Add(Actor, FMapEditorNetTransform(Actor->GetActorTransform()));
+	}
+}
+
+void UMapEditorHandlerComponent::EndEdit(AActor* Actor)
+{
+	EndEdits(TArray<AActor*>({ Actor }));
+}
+
+void UMapEditorHandlerComponent::EndEdits(const TArray<AActor*>& Actors)
+{
+	// All actors of one edit become a single command
+	TArray<FMapEditorCommandEntry> Entries;
+	EMapEditorCommandType Type = EMapEditorCommandType::None;
+	for (AActor* Actor : Actors)
+	{
+		FMapEditorNetTransform Before;
+		if (!Actor || !EditStartTransforms.RemoveAndCopyValue(Actor, Before)) continue;
+
+		const FMapEditorNetTransform After(Actor->GetActorTransform());
+		if (Type == EMapEditorCommandType::None)
 		{
-			Gizmo->ClearGizmo();
-			Gizmo->HideGizmo(true);
+			if (!Before.Location.Equals(After.Location))
+			{
+				Type = EMapEditorCommandType::Move;
+			}
+			else if (!Before.Rotation.Equals(After.Rotation))
+			{
+				Type = EMapEditorCommandType::Rotate;
+			}
+			else if (!Before.Scale.Equals(After.Scale))
+			{
+				Type = EMapEditorCommandType::Scale;
+			}
 		}
-		CurrentActor = nullptr;
+
+		FMapEditorCommandEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Actor = Actor;
+		Entry.ActorClass = Actor->GetClass();
+		Entry.Before = Before;
+		Entry.After = After;
+	}
+
+	if (Type != EMapEditorCommandType::None)
+	{
+		Journal.Record(Type).Entries = MoveTemp(Entries);
+		UpdateJournalIds();
 	}
 }
 
-void UMapEditorHandlerComponent::Undo()
+bool UMapEditorHandlerComponent::ApplyCommand(FMapEditorCommand& Command, bool bUndo)
 {
-	int32 Index = UndoSteps.Num() - 1;
-	if (Index >= 0)
+	// Actors brought back by undo or redo go through the same checks as new ones, the command stays in the journal if they fail
+	const bool bRespawns = bUndo ? Command.Type == EMapEditorCommandType::Delete
+		: Command.Type == EMapEditorCommandType::Spawn || Command.Type == EMapEditorCommandType::Duplicate;
+	if (bRespawns)
 	{
-		FMapEditorSteps UndoStep = UndoSteps[Index];
-		if (UndoStep.Actor && UndoStep.Transforms.Num() - 1)
+		for (const FMapEditorCommandEntry& Entry : Command.Entries)
 		{
-			const int32 TransformIndex = UndoStep.Transforms.Num() - 1;
-			if (TransformIndex - 1 >= 0)
+			if (!IsSpawnAllowed(Entry.ActorClass, (bUndo ? Entry.Before : Entry.After).ToTransform().GetLocation())) return false;
+		}
+		if (!AllowSpawnBudget(Command.Entries.Num())) return false;
+	}
+	
+	const UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>();
+	TArray<AActor*> EditedActors;
+	for (FMapEditorCommandEntry& Entry : Command.Entries)
+	{
+		// A pooled actor may have been handed out again as something else, leave it alone
+		AActor* EntryActor = Entry.Actor.Get();
+		if (EntryActor && Subsystem && !Subsystem->IsMapActor(EntryActor))
+		{
+			EntryActor = nullptr;
+		}
+		
+		switch (Command.Type)
+		{
+		case EMapEditorCommandType::Spawn:
+		case EMapEditorCommandType::Duplicate:
 			{
-				UndoStep.Actor->SetActorTransform(UndoStep.Transforms[TransformIndex - 1]);
-				UndoStep.Transforms.RemoveAt(TransformIndex);
-				UndoSteps[Index] = UndoStep;
-				if (Gizmo.IsValid())
+				if (!bUndo)
 				{
-					CurrentActor = UndoStep.Actor;
-					if (CurrentActor->Implements<UMapEditorInterface>())
-					{
-						IMapEditorInterface::Execute_OnUndo(CurrentActor);
-					}
-					Gizmo->SnapToActor(CurrentActor);
-					ReplicateActor();
+					RespawnActor(Entry, Entry.After);
+				}
+				else if (EntryActor)
+				{
+					EntryActor->Destroy();
 				}
+				break;
 			}
-			else
+		case EMapEditorCommandType::Delete:
 			{
-				UndoSteps.RemoveAt(Index);
-				Undo();
+				if (bUndo)
+				{
+					RespawnActor(Entry, Entry.Before);
+				}
+				else if (EntryActor)
+				{
+					Entry.Materials = UMapEditorStatics::MakeMapItem(EntryActor).Materials;
+					EntryActor->Destroy();
+				}
+				break;
+			}
+		default:
+			{
+				if (EntryActor)
+				{
+					EntryActor->SetActorTransform((bUndo ? Entry.Before : Entry.After).ToTransform());
+					if (bUndo && EntryActor->Implements<UMapEditorInterface>())
+					{
+						IMapEditorInterface::Execute_OnUndo(EntryActor);
+					}
+					EditedActors.Add(EntryActor);
+				}
+				break;
 			}
 		}
-		else
+	}
+
+	// The whole edited group is selected again, not just one of its actors
+	if (EditedActors.Num())
+	{
+		Client_RestoreSelection(EditedActors);
+	}
+	return true;
+}
+
+void UMapEditorHandlerComponent::Client_RestoreSelection_Implementation(const TArray<AActor*>& Actors)
+{
+	SelectActors(Actors);
+}
+
+AActor* UMapEditorHandlerComponent::RespawnActor(FMapEditorCommandEntry& Entry, const FMapEditorNetTransform& Transform)
+{
+	if (!Entry.ActorClass) return nullptr;
+
+	const TWeakObjectPtr<AActor> OldActor = Entry.Actor;
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(Entry.ActorClass, Transform.ToTransform());
+	if (Actor)
+	{
+		FMapEditorItem Item;
+		Item.Materials = Entry.Materials;
+		UMapEditorStatics::ApplyItemMaterials(Actor, Item);
+		Journal.RemapActor(OldActor, Actor);
+	}
+	return Actor;
+}
+
+AActor* UMapEditorHandlerComponent::SpawnActorInternal(TSubclassOf<AActor> ActorClass, const FTransform& Transform, EMapEditorCommandType CommandType)
+{
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(ActorClass, Transform);
+	if (Actor)
+	{
+		FMapEditorCommandEntry& Entry = Journal.Record(CommandType).Entries.AddDefaulted_GetRef();
+		Entry.Actor = Actor;
+		Entry.ActorClass = ActorClass;
+		Entry.Before = FMapEditorNetTransform(Actor->GetActorTransform());
+		Entry.After = Entry.Before;
+		UpdateJournalIds();
+	}
+	return Actor;
+}
+
+void UMapEditorHandlerComponent::DeleteActorsInternal(const TArray<AActor*>& Actors)
+{
+	TArray<AActor*> ValidActors;
+	for (AActor* Actor : Actors)
+	{
+		if (IsValid(Actor))
 		{
-			UndoSteps.RemoveAt(Index);
-			Undo();
+			ValidActors.Add(Actor);
 		}
 	}
+	if (!ValidActors.Num()) return;
+
+	FMapEditorCommand& Command = Journal.Record(EMapEditorCommandType::Delete);
+	for (AActor* Actor : ValidActors)
+	{
+		const FMapEditorItem Item = UMapEditorStatics::MakeMapItem(Actor);
+		FMapEditorCommandEntry& Entry = Command.Entries.AddDefaulted_GetRef();
+		Entry.Actor = Actor;
+		Entry.ActorClass = Item.ActorToSpawn;
+		Entry.Before = FMapEditorNetTransform(Item.ItemTransform);
+		Entry.After = Entry.Before;
+		Entry.Materials = Item.Materials;
+		Actor->Destroy();
+	}
+	UpdateJournalIds();
 }
 
 void UMapEditorHandlerComponent::SetSnapAmount(FMapEditorSnapping SnappingAmounts)
@@ -435,7 +1142,10 @@ bool UMapEditorHandlerComponent::Server_SpawnActor_Validate(TSubclassOf<AActor>
 
 void UMapEditorHandlerComponent::Server_SpawnActor_Implementation(TSubclassOf<AActor> ActorClass)
 {
-	SpawnActor(ActorClass);
+	if (GetOwner() && AllowSpawn(ActorClass, GetOwner()->GetActorTransform()))
+	{
+		SpawnActor(ActorClass);
+	}
 }
 
 void UMapEditorHandlerComponent::SpawnActor(TSubclassOf<AActor> ActorClass)
@@ -460,7 +1170,7 @@ void UMapEditorHandlerComponent::SpawnActor(TSubclassOf<AActor> ActorClass)
 
 				Transform.SetRotation(FRotator::ZeroRotator.Quaternion());
 				
-				CurrentActor = GetWorld()->SpawnActor<AActor>(ActorClass, Transform);
+				CurrentActor = SpawnActorInternal(ActorClass, Transform, EMapEditorCommandType::Spawn);
 				OnRep_CurrentActor();
 			}
 		}
@@ -473,12 +1183,15 @@ void UMapEditorHandlerComponent::SpawnActor(TSubclassOf<AActor> ActorClass)
 
 bool UMapEditorHandlerComponent::Server_SpawnActorAtTransform_Validate(TSubclassOf<AActor> ActorClass, const FTransform& Transform)
 {
-	return true;
+	return !Transform.ContainsNaN();
 }
 
 void UMapEditorHandlerComponent::Server_SpawnActorAtTransform_Implementation(TSubclassOf<AActor> ActorClass, const FTransform& Transform)
 {
-	SpawnActorAtTransform(ActorClass, Transform);
+	if (AllowSpawn(ActorClass, Transform))
+	{
+		SpawnActorAtTransform(ActorClass, ClampToEditLimits(Transform));
+	}
 }
 
 void UMapEditorHandlerComponent::SpawnActorAtTransform(TSubclassOf<AActor> ActorClass, const FTransform SpawnTransform)
@@ -489,7 +1202,7 @@ void UMapEditorHandlerComponent::SpawnActorAtTransform(TSubclassOf<AActor> Actor
 		{
 			if (GetOwner())
 			{
-				CurrentActor = GetWorld()->SpawnActor<AActor>(ActorClass, SpawnTransform);
+				CurrentActor = SpawnActorInternal(ActorClass, SpawnTransform, EMapEditorCommandType::Spawn);
 				OnRep_CurrentActor();
 			}
 		}
@@ -507,8 +1220,210 @@ bool UMapEditorHandlerComponent::Server_DeleteActor_Validate(AActor* Actor)
 
 void UMapEditorHandlerComponent::Server_DeleteActor_Implementation(AActor* Actor)
 {
-	if (Actor)
+	if (IsEditableActor(Actor) && AllowCommit())
 	{
-		Actor->Destroy();
+		DeleteActorsInternal(TArray<AActor*>({ Actor }));
+	}
+}
+
+bool UMapEditorHandlerComponent::Server_DeleteActors_Validate(const TArray<AActor*>& Actors)
+{
+	return Actors.Num() <= MaxActorsPerRequest;
+}
+
+void UMapEditorHandlerComponent::Server_DeleteActors_Implementation(const TArray<AActor*>& Actors)
+{
+	TArray<AActor*> EditableActors;
+	FilterEditableActors(Actors, EditableActors);
+	if (EditableActors.Num() && AllowCommit(EditableActors.Num()))
+	{
+		DeleteActorsInternal(EditableActors);
+	}
+}
+
+bool UMapEditorHandlerComponent::Server_DuplicateActors_Validate(const TArray<AActor*>& Actors, FVector Offset)
+{
+	return Actors.Num() <= MaxActorsPerRequest && !Offset.ContainsNaN();
+}
+
+void UMapEditorHandlerComponent::Server_DuplicateActors_Implementation(const TArray<AActor*>& Actors, FVector Offset)
+{
+	if (!Actors.Num() || !GetOwner()) return;
+
+	// The whole group is checked against the cap and the spawn budget at once
+	TArray<AActor*> SourceActors;
+	for (AActor* Actor : Actors)
+	{
+		if (IsEditableActor(Actor) && IsSpawnAllowed(Actor->GetClass(), Actor->GetActorLocation() + Offset))
+		{
+			SourceActors.Add(Actor);
+		}
+	}
+	if (!SourceActors.Num() || !AllowSpawnBudget(SourceActors.Num())) return;
+
+	TArray<AActor*> NewActors;
+	FMapEditorCommand& Command = Journal.Record(EMapEditorCommandType::Duplicate);
+	for (AActor* Actor : SourceActors)
+	{
+		FTransform SpawnTransform = Actor->GetActorTransform();
+		SpawnTransform.AddToTranslation(Offset);
+		SpawnTransform = ClampToEditLimits(SpawnTransform);
+		if (AActor* NewActor = GetWorld()->SpawnActor<AActor>(Actor->GetClass(), SpawnTransform))
+		{
+			FMapEditorCommandEntry& Entry = Command.Entries.AddDefaulted_GetRef();
+			Entry.Actor = NewActor;
+			Entry.ActorClass = Actor->GetClass();
+			Entry.Before = FMapEditorNetTransform(NewActor->GetActorTransform());
+			Entry.After = Entry.Before;
+			NewActors.Add(NewActor);
+		}
+	}
+	UpdateJournalIds();
+
+	DuplicatedActors = NewActors;
+	OnRep_DuplicatedActors();
+}
+
+bool UMapEditorHandlerComponent::Server_DuplicateActor_Validate(TSubclassOf<AActor> ActorClass, const FTransform& Transform)
+{
+	return !Transform.ContainsNaN();
+}
+
+void UMapEditorHandlerComponent::Server_DuplicateActor_Implementation(TSubclassOf<AActor> ActorClass, const FTransform& Transform)
+{
+	if (ActorClass && GetOwner() && AllowSpawn(ActorClass, Transform))
+	{
+		CurrentActor = SpawnActorInternal(ActorClass, Transform, EMapEditorCommandType::Duplicate);
+		OnRep_CurrentActor();
+	}
+}
+
+bool UMapEditorHandlerComponent::AllowSpawn(UClass* ActorClass, const FTransform& Transform)
+{
+	return IsSpawnAllowed(ActorClass, Transform.GetLocation()) && AllowSpawnBudget(1);
+}
+
+bool UMapEditorHandlerComponent::IsSpawnAllowed(UClass* ActorClass, const FVector& Location)
+{
+	const UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>();
+	if (!Subsystem) return ActorClass != nullptr;
+
+	if (!Subsystem->IsClassAllowed(ActorClass))
+	{
+		RecordEdit(EMapEditorEditResult::ClassNotAllowed);
+		return false;
+	}
+	if (!Subsystem->IsInEditBounds(Location))
+	{
+		RecordEdit(EMapEditorEditResult::OutOfBounds);
+		return false;
+	}
+	return true;
+}
+
+FMapEditorPlayerBudget* UMapEditorHandlerComponent::GetPlayerBudget(UMapEditorSubsystem* Subsystem) const
+{
+	const AController* Controller = Cast<AController>(GetOwner());
+	if (const APawn* OwningPawn = GetOwner<APawn>())
+	{
+		Controller = OwningPawn->GetController();
+	}
+	return Controller ? &Subsystem->GetPlayerBudget(Controller) : nullptr;
+}
+
+bool UMapEditorHandlerComponent::AllowSpawnBudget(int32 Num)
+{
+	UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>();
+	if (!Subsystem) return true;
+
+	if (!Subsystem->IsBelowActorCap(Num))
+	{
+		RecordEdit(EMapEditorEditResult::OverActorCap, Num);
+		return false;
+	}
+	const FMapEditorEditLimits& Limits = Subsystem->EditLimits;
+	FMapEditorPlayerBudget* Budget = GetPlayerBudget(Subsystem);
+	if (!Budget || !Budget->Spawns.Consume(GetWorld()->GetRealTimeSeconds(), Limits.SpawnsPerSecond, Limits.SpawnBurst, Num))
+	{
+		RecordEdit(EMapEditorEditResult::RateLimited, Num);
+		return false;
+	}
+	RecordEdit(EMapEditorEditResult::Accepted, Num);
+	return true;
+}
+
+bool UMapEditorHandlerComponent::AllowTransformUpdate(int32 Num)
+{
+	UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>();
+	if (!Subsystem) return true;
+
+	const FMapEditorEditLimits& Limits = Subsystem->EditLimits;
+	FMapEditorPlayerBudget* Budget = GetPlayerBudget(Subsystem);
+	const bool bAllowed = Budget && Budget->Transforms.Consume(GetWorld()->GetRealTimeSeconds(), Limits.TransformsPerSecond, Limits.TransformBurst, Num);
+	RecordEdit(bAllowed ? EMapEditorEditResult::Accepted : EMapEditorEditResult::RateLimited, Num);
+	return bAllowed;
+}
+
+bool UMapEditorHandlerComponent::AllowCommit(int32 Num)
+{
+	UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>();
+	if (!Subsystem) return true;
+
+	const FMapEditorEditLimits& Limits = Subsystem->EditLimits;
+	FMapEditorPlayerBudget* Budget = GetPlayerBudget(Subsystem);
+	const bool bAllowed = Budget && Budget->Commits.Consume(GetWorld()->GetRealTimeSeconds(), Limits.CommitsPerSecond, Limits.CommitBurst, Num);
+	RecordEdit(bAllowed ? EMapEditorEditResult::Accepted : EMapEditorEditResult::RateLimited, Num);
+	return bAllowed;
+}
+
+bool UMapEditorHandlerComponent::AllowUndo()
+{
+	UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>();
+	if (!Subsystem) return true;
+
+	FMapEditorPlayerBudget* Budget = GetPlayerBudget(Subsystem);
+	const bool bAllowed = Budget && Budget->Undos.Consume(GetWorld()->GetRealTimeSeconds(), Subsystem->EditLimits.UndosPerSecond, Subsystem->EditLimits.UndosPerSecond);
+	RecordEdit(bAllowed ? EMapEditorEditResult::Accepted : EMapEditorEditResult::RateLimited);
+	return bAllowed;
+}
+
+bool UMapEditorHandlerComponent::IsEditableActor(const AActor* Actor) const
+{
+	// Clients can only touch map actors, never pawns, controllers or anything else they can reference
+	return IsValid(Actor) && Actor->Implements<UMapEditorInterface>() && !UMapEditorSubsystem::IsPooled(Actor) && Actor->IsRootComponentMovable();
+}
+
+void UMapEditorHandlerComponent::FilterEditableActors(const TArray<AActor*>& Actors, TArray<AActor*>& OutActors)
+{
+	OutActors.Reserve(Actors.Num());
+	for (AActor* Actor : Actors)
+	{
+		if (IsEditableActor(Actor))
+		{
+			OutActors.AddUnique(Actor);
+		}
+		else
+		{
+			RecordEdit(EMapEditorEditResult::NotEditable);
+		}
+	}
+}
+
+FTransform UMapEditorHandlerComponent::ClampToEditLimits(const FTransform& Transform) const
+{
+	const UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>();
+	return Subsystem ? Subsystem->ClampToEditLimits(Transform) : Transform;
+}
+
+void UMapEditorHandlerComponent::RecordEdit(EMapEditorEditResult Result, int32 Count)
+{
+	EditMetrics.Add(Result, Count);
+	if (UMapEditorSubsystem* Subsystem = GetWorld()->GetSubsystem<UMapEditorSubsystem>())
+	{
+		Subsystem->EditMetrics.Add(Result, Count);
+	}
+	if (Result != EMapEditorEditResult::Accepted)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("MapEditor edit from %s dropped: %s"), *GetNameSafe(GetOwner()), *UEnum::GetValueAsString(Result));
 	}
 }
\ No newline at end of file
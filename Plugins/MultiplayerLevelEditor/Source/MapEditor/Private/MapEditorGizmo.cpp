@@ -14,6 +14,8 @@
 AMapEditorGizmo::AMapEditorGizmo()
 {
 	PrimaryActorTick.bCanEverTick = true;
+	// Ticking is only needed while dragging, see HitGizmo
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	Origin = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("OriginComponent"));
 	RootComponent = Origin;
@@ -42,7 +44,15 @@ AMapEditorGizmo::AMapEditorGizmo()
 	ScaleX->SetupAttachment(ScaleZ);
 	ScaleY->SetupAttachment(ScaleX);
 	
+	// Gizmo meshes are drawn on top of the scene and never need shadows
+	for (UStaticMeshComponent* Mesh : { Origin, ZAxis, XAxis, YAxis, Yaw, Roll, Pitch, ScaleZ, ScaleX, ScaleY })
+	{
+		Mesh->SetCastShadow(false);
+		Mesh->bReceivesDecals = false;
+	}
+	
 	MovementSlowdown = 1.0f;
+	InvLocationSnap = 0.0f;
 	
 	bGrabbed = false;
 }
@@ -57,124 +67,108 @@ void AMapEditorGizmo::BeginPlay()
 	SetActorHiddenInGame(true);
 }
 
+void AMapEditorGizmo::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ViewComponent.IsValid())
+	{
+		ViewComponent->TransformUpdated.RemoveAll(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
 void AMapEditorGizmo::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
-	if (!IsHidden() && CurrentActor && OwningController.IsValid())
+	if (bGrabbed && !IsHidden() && CurrentActor && OwningController.IsValid())
 	{
-		if (APawn* Pawn = OwningController->GetPawn())
-		{
-			float Distance = FVector::Distance(Pawn->GetActorLocation(), GetActorLocation());
-			FVector Scale = FVector(1.0f, 1.0f, 1.0f);
-			Scale *= Distance / 1000.0f;
-			SetActorScale3D(Scale);
-		}
-
-		if (bGrabbed)
+		UpdateGizmoScale();
+		switch (CurrentGizmo)
 		{
-			switch (CurrentGizmo)
-			{
-				case EGizmoType::Location: HandleMovement(); break;
-				case EGizmoType::Rotation: HandleRotation(); break;
-				case EGizmoType::Scale: HandleScale(); break;
-			}
+			case EGizmoType::Location: HandleMovement(); break;
+			case EGizmoType::Rotation: HandleRotation(); break;
+			case EGizmoType::Scale: HandleScale(); break;
 		}
 	}
 }
 
-bool AMapEditorGizmo::GreaterThanSnapAmount(float Current, float New)
+void AMapEditorGizmo::UpdateGizmoScale()
 {
-	if (HandlerComponent)
+	if (!OwningController.IsValid()) return;
+	
+	if (APawn* Pawn = OwningController->GetPawn())
 	{
-		float SnapAmount = 0.0f;
-		switch (CurrentGizmo)
+		const FVector Scale = FVector(FVector::Distance(Pawn->GetActorLocation(), GetActorLocation()) / 1000.0f);
+		if (!GetActorScale3D().Equals(Scale, Scale.X * 0.01f))
 		{
-		case EGizmoType::Location: SnapAmount = HandlerComponent->GetSnapAmount().Location; break;
-		case EGizmoType::Rotation: SnapAmount = HandlerComponent->GetSnapAmount().Rotation; break;
-		case EGizmoType::Scale: SnapAmount = 2.0f; break;
+			SetActorScale3D(Scale);
 		}
+	}
+}
 
-		float Diff = New - (Current + SnapAmount);
+void AMapEditorGizmo::TrackView()
+{
+	// Keeps the gizmo scaled to the camera distance without ticking, the pawn can change on possession
+	APawn* Pawn = OwningController.IsValid() ? OwningController->GetPawn() : nullptr;
+	USceneComponent* NewViewComponent = Pawn ? Pawn->GetRootComponent() : nullptr;
+	if (ViewComponent.Get() == NewViewComponent) return;
+	
+	if (ViewComponent.IsValid())
+	{
+		ViewComponent->TransformUpdated.RemoveAll(this);
+	}
+	ViewComponent = NewViewComponent;
+	if (NewViewComponent)
+	{
+		NewViewComponent->TransformUpdated.AddUObject(this, &AMapEditorGizmo::OnViewMoved);
+	}
+}
 
-		if (New >= Current + SnapAmount)
-		{
-			return true;
-		}
-		else if (New <= Current - SnapAmount)
-		{
-			return true;
-		}
+void AMapEditorGizmo::OnViewMoved(USceneComponent* Component, EUpdateTransformFlags UpdateFlags, ETeleportType Teleport)
+{
+	if (!bGrabbed && !IsHidden() && CurrentActor)
+	{
+		UpdateGizmoScale();
 	}
-	return false;
 }
 
 void AMapEditorGizmo::HandleMovement()
 {
+	const int32 Axis = MoveAxis == EMoveAxis::XAxis ? 0 : MoveAxis == EMoveAxis::YAxis ? 1 : MoveAxis == EMoveAxis::ZAxis ? 2 : INDEX_NONE;
+	if (Axis == INDEX_NONE) return;
+	
 	FVector MouseLocation;
 	FVector MouseDirection;
 	OwningController->DeprojectMousePositionToWorld(MouseLocation, MouseDirection);
-	
+
+	// Mouse travel since the last step, scaled based on distance
 	const float Distance = FVector::Distance(MouseLocation, CurrentActor->GetActorLocation());
-	FVector MouseWorldPOS = MouseLocation + MouseDirection * Distance;
-	
-	FVector CurrentLocation = GetActorLocation();
+	const float Slowdown = MovementSlowdown > 0.0f ? MovementSlowdown : 1.0f;
+	const float Delta = (MouseLocation[Axis] - CurrentMouseWorldPos[Axis]) * Distance / Slowdown;
 
-	const FVector Difference = MouseWorldPOS - CurrentLocation;
-	MouseWorldPOS -= Difference;
-	
-	const FVector Diff = MouseLocation - CurrentMouseWorldPos;
-	MouseWorldPOS += Diff * Distance / (MovementSlowdown > 0.0f ? MovementSlowdown : 1.0f); // Scale based on distance
+	// Only whole snap steps are taken, the rest carries over to the next frame
+	const float Step = InvLocationSnap > 0.0f ? FMath::TruncToFloat(Delta * InvLocationSnap) * DragSnap.Location : Delta;
+	if (Step == 0.0f) return;
 
-	const float SnapAmount = HandlerComponent->GetSnapAmount().Rotation;
-	
-	bool bMoved = false;
-	int32 NumberOfSnaps;
-	switch (MoveAxis)
-	{
-	case EMoveAxis::XAxis:
-		{
-			if (GreaterThanSnapAmount(CurrentLocation.X, MouseWorldPOS.X))
-			{
-				NumberOfSnaps = ( MouseWorldPOS.X - CurrentLocation.X ) / HandlerComponent->GetSnapAmount().Location;
-				CurrentLocation.X += SnapAmount * NumberOfSnaps;
-				bMoved = true;
-			}
-			break;
-		}
-	case EMoveAxis::YAxis:
-		{
-			if (GreaterThanSnapAmount(CurrentLocation.Y, MouseWorldPOS.Y))
-			{
-				NumberOfSnaps = ( MouseWorldPOS.Y - CurrentLocation.Y ) / HandlerComponent->GetSnapAmount().Location;
-				CurrentLocation.Y += SnapAmount * NumberOfSnaps;
-				bMoved = true;
-			}
-			break;
-		}
-	case EMoveAxis::ZAxis:
-		{
-			if (GreaterThanSnapAmount(CurrentLocation.Z, MouseWorldPOS.Z))
-			{
-				NumberOfSnaps = ( MouseWorldPOS.Z - CurrentLocation.Z ) / HandlerComponent->GetSnapAmount().Location;
-				CurrentLocation.Z += SnapAmount * NumberOfSnaps;
-				bMoved = true;
-			}
-			break;
-		}
-	}
+	FVector CurrentLocation = GetActorLocation();
+	CurrentLocation[Axis] += Step;
 	
-	if (bMoved)
+	// The handler moves every selected actor by the same offset as the gizmo
+	HandlerComponent->MoveSelection(CurrentLocation - GetActorLocation());
+	SetActorLocation(CurrentLocation);
+
+	// Only the mouse travel used by the step is consumed
+	const float MouseStart = CurrentMouseWorldPos[Axis];
+	CurrentMouseWorldPos = MouseLocation;
+	if (Step != Delta && Distance > 0.0f)
 	{
-		SetActorLocation(CurrentLocation);
-		CurrentMouseWorldPos = MouseLocation;
-		CurrentActor->SetActorLocation(CurrentLocation);
+		CurrentMouseWorldPos[Axis] = MouseStart + Step * Slowdown / Distance;
 	}
 }
 
 void AMapEditorGizmo::HandleRotation()
 {
 	const FVector Difference = ClickedMouseWorldPos - GetMouseWorldPosition();	
-	const float SnapAmount = HandlerComponent->GetSnapAmount().Rotation;
+	const float SnapAmount = DragSnap.Rotation;
 	
 	const float MousePOSDifference = (Difference.X + Difference.Y) * 10.0f;
 	if (MousePOSDifference > SnapAmount || MousePOSDifference < -SnapAmount)
@@ -187,19 +181,19 @@ void AMapEditorGizmo::HandleRotation()
 		{
 		case ERotationAxis::Yaw: // Yaw
 			{
-				CurrentRotation.Yaw += HandlerComponent->GetSnapAmount().Rotation * bRotatingLeftOfScreen;
+				CurrentRotation.Yaw += SnapAmount * bRotatingLeftOfScreen;
 				bRotated = true;
 				break;
 			}
 		case ERotationAxis::Roll:
 			{
-				CurrentRotation.Pitch += HandlerComponent->GetSnapAmount().Rotation * bRotatingLeftOfScreen;
+				CurrentRotation.Pitch += SnapAmount * bRotatingLeftOfScreen;
 				bRotated = true;
 				break;
 			}
 		case ERotationAxis::Pitch:
 			{
-				CurrentRotation.Roll -= HandlerComponent->GetSnapAmount().Rotation * bRotatingLeftOfScreen;
+				CurrentRotation.Roll -= SnapAmount * bRotatingLeftOfScreen;
 				bRotated = true;
 				break;
 			}
@@ -207,7 +201,7 @@ void AMapEditorGizmo::HandleRotation()
 
 		if (bRotated)
 		{
-			CurrentActor->AddActorWorldRotation(CurrentRotation);
+			HandlerComponent->RotateSelection(CurrentRotation);
 			ClickedMousePos = GetMousePosition();
 			ClickedMouseWorldPos = GetMouseWorldPosition();
 		}
@@ -260,7 +254,7 @@ void AMapEditorGizmo::HandleScale()
 	
 	if (bScaled)
 	{
-		CurrentActor->SetActorScale3D(CurrentScale);
+		HandlerComponent->ScaleSelection(CurrentScale - CurrentActor->GetActorScale3D());
 		ClickedMousePos = GetMousePosition();
 		ClickedMouseWorldPos = GetMouseWorldPosition();
 	}
@@ -281,6 +275,8 @@ void AMapEditorGizmo::SnapToActor(AActor* Actor)
 			//SetActorRotation(FRotator::ZeroRotator);
 		}
 		SetActorRotation(FRotator::ZeroRotator);
+		TrackView();
+		UpdateGizmoScale();
 	}
 }
 
@@ -375,6 +371,11 @@ void AMapEditorGizmo::HideGizmo(bool Hide)
 {
 	SetActorHiddenInGame(Hide);
 	SetActorEnableCollision(!Hide);
+	if (!Hide)
+	{
+		TrackView();
+		UpdateGizmoScale();
+	}
 }
 
 void AMapEditorGizmo::ClearGizmo()
@@ -387,6 +388,9 @@ void AMapEditorGizmo::HitGizmo(FHitResult HitResult)
 	if (OwningController.IsValid())
 	{
 		bGrabbed = true;
+		SetActorTickEnabled(true);
+		DragSnap = HandlerComponent ? HandlerComponent->GetSnapAmount() : FMapEditorSnapping();
+		InvLocationSnap = DragSnap.Location > 0.0f ? 1.0f / DragSnap.Location : 0.0f;
 		CurrentMouseWorldPos = GetMouseWorldPosition();
 		MoveAxis = GetMoveAxis(HitResult.GetComponent());
 		switch (CurrentGizmo)
@@ -407,6 +411,7 @@ void AMapEditorGizmo::ReleaseGizmo()
 {
 	GetWorld()->GetTimerManager().ClearTimer(TReplicateHandle);
 	bGrabbed = false;
+	SetActorTickEnabled(false);
 	MoveAxis = EMoveAxis::None;
 	if (CurrentGizmo == EGizmoType::Rotation && CurrentActor)
 	{
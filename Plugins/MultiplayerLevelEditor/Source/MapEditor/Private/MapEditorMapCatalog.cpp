@@ -0,0 +1,276 @@
+// Copyright 2021, Dakota Dawe, All rights reserved
+
+
+#include "MapEditorMapCatalog.h"
+#include "MapEditorStatics.h"
+
+#include "Kismet/GameplayStatics.h"
+#include "Engine/GameInstance.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UMapEditorMapCatalog* UMapEditorMapCatalog::Get(const UObject* WorldContextObject)
+{
+	const UGameInstance* GameInstance = WorldContextObject ? UGameplayStatics::GetGameInstance(WorldContextObject) : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UMapEditorMapCatalog>() : nullptr;
+}
+
+void UMapEditorMapCatalog::Deinitialize()
+{
+	for (TPair<FString, TFuture<void>>& PendingSave : PendingSaves)
+	{
+		PendingSave.Value.Wait();
+	}
+	PendingSaves.Empty();
+	Directories.Empty();
+	Changes.Empty();
+	Super::Deinitialize();
+}
+
+FString UMapEditorMapCatalog::GetDirectoryKey(const FString& MapDirectory)
+{
+	FString Directory = FPaths::ConvertRelativePathToFull(MapDirectory);
+	FPaths::NormalizeDirectoryName(Directory);
+	return Directory;
+}
+
+FMapEditorMapInfo UMapEditorMapCatalog::MakeMapInfo(const FString& FileName, int64 FileSize, const FDateTime& Timestamp, int32 ItemCount)
+{
+	FMapEditorMapInfo Info;
+	Info.FileName = FileName;
+	Info.MapName = UMapEditorStatics::GetRealMapName(UMapEditorStatics::RemoveExtension(FileName));
+	FileName.Split(TEXT("&"), &Info.LevelName, nullptr);
+	Info.FileSize = FileSize;
+	Info.Timestamp = Timestamp;
+	Info.ItemCount = ItemCount;
+	return Info;
+}
+
+int32 UMapEditorMapCatalog::ReadItemCount(const TCHAR* FilePath)
+{
+	// Current maps store the count in the header, older ones have to be decoded once
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(FilePath));
+		if (!Reader) return INDEX_NONE;
+		
+		uint16 Version = 0;
+		uint8 Flags = 0;
+		int32 UncompressedSize = 0;
+		int32 ItemNum = INDEX_NONE;
+		if (UMapEditorStatics::ReadMapHeader(*Reader, Version, Flags, UncompressedSize, ItemNum) && ItemNum != INDEX_NONE)
+		{
+			return ItemNum;
+		}
+	}
+
+	TArray<uint8> Data;
+	FMapEditorMapFile File;
+	if (FFileHelper::LoadFileToArray(Data, FilePath) && UMapEditorStatics::DecodeMapFile(Data, File))
+	{
+		return UMapEditorStatics::GetMapFileItemCount(File);
+	}
+	return INDEX_NONE;
+}
+
+void UMapEditorMapCatalog::RefreshMapList(const FString& MapDirectory, const FString& LevelName, FMapEditorMapListCompleted OnCompleted)
+{
+	const FString Directory = GetDirectoryKey(MapDirectory);
+	TWeakObjectPtr<UMapEditorMapCatalog> WeakThis(this);
+	const uint64 ScanSerial = ChangeSerial;
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Directory, LevelName, OnCompleted, ScanSerial, Known = Directories.FindRef(Directory)]()
+	{
+		TMap<FString, FMapEditorMapInfo> Maps;
+		IFileManager::Get().IterateDirectoryStat(*Directory, [&Maps, &Known](const TCHAR* Path, const FFileStatData& StatData)
+		{
+			const FString FileName = FPaths::GetCleanFilename(Path);
+			if (StatData.bIsDirectory || !FileName.EndsWith(TEXT(".skmap"))) return true;
+
+			const FMapEditorMapInfo* Cached = Known.Find(FileName);
+			if (Cached && Cached->FileSize == StatData.FileSize && Cached->Timestamp == StatData.ModificationTime)
+			{
+				Maps.Add(FileName, *Cached);
+			}
+			else
+			{
+				Maps.Add(FileName, MakeMapInfo(FileName, StatData.FileSize, StatData.ModificationTime, ReadItemCount(Path)));
+			}
+			return true;
+		});
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Directory, LevelName, OnCompleted, ScanSerial, Maps = MoveTemp(Maps)]() mutable
+		{
+			if (UMapEditorMapCatalog* Catalog = WeakThis.Get())
+			{
+				// Saves and deletes that finished during the scan are newer than what it found, anything else missing is gone
+				if (const TMap<FString, FMapChange>* DirectoryChanges = Catalog->Changes.Find(Directory))
+				{
+					for (const TPair<FString, FMapChange>& Change : *DirectoryChanges)
+					{
+						if (Change.Value.Serial <= ScanSerial) continue;
+						if (Change.Value.Info.IsSet())
+						{
+							Maps.Add(Change.Key, Change.Value.Info.GetValue());
+						}
+						else
+						{
+							Maps.Remove(Change.Key);
+						}
+					}
+				}
+				Catalog->Directories.Add(Directory, MoveTemp(Maps));
+				OnCompleted.ExecuteIfBound(Catalog->GetMapList(Directory, LevelName));
+			}
+		});
+	});
+}
+
+bool UMapEditorMapCatalog::HasMapList(const FString& MapDirectory) const
+{
+	return Directories.Contains(GetDirectoryKey(MapDirectory));
+}
+
+TArray<FMapEditorMapInfo> UMapEditorMapCatalog::GetMapList(const FString& MapDirectory, const FString& LevelName) const
+{
+	TArray<FMapEditorMapInfo> Maps;
+	if (const TMap<FString, FMapEditorMapInfo>* Files = Directories.Find(GetDirectoryKey(MapDirectory)))
+	{
+		Maps.Reserve(Files->Num());
+		for (const TPair<FString, FMapEditorMapInfo>& File : *Files)
+		{
+			if (LevelName.IsEmpty() || File.Value.LevelName == LevelName)
+			{
+				Maps.Add(File.Value);
+			}
+		}
+		Maps.Sort([](const FMapEditorMapInfo& A, const FMapEditorMapInfo& B) { return A.FileName < B.FileName; });
+	}
+	return Maps;
+}
+
+void UMapEditorMapCatalog::UpdateMap(const FString& MapDirectory, const FMapEditorMapInfo& Info)
+{
+	// Directories that were never listed stay unscanned, the first list reads them in full
+	const FString Directory = GetDirectoryKey(MapDirectory);
+	RecordChange(Directory, Info.FileName, &Info);
+	if (TMap<FString, FMapEditorMapInfo>* Files = Directories.Find(Directory))
+	{
+		Files->Add(Info.FileName, Info);
+	}
+}
+
+void UMapEditorMapCatalog::RemoveMap(const FString& MapDirectory, const FString& FileName)
+{
+	const FString Directory = GetDirectoryKey(MapDirectory);
+	RecordChange(Directory, FileName, nullptr);
+	if (TMap<FString, FMapEditorMapInfo>* Files = Directories.Find(Directory))
+	{
+		Files->Remove(FileName);
+	}
+}
+
+void UMapEditorMapCatalog::RecordChange(const FString& Directory, const FString& FileName, const FMapEditorMapInfo* Info)
+{
+	FMapChange& Change = Changes.FindOrAdd(Directory).FindOrAdd(FileName);
+	Change.Serial = ++ChangeSerial;
+	Change.Info.Reset();
+	if (Info)
+	{
+		Change.Info = *Info;
+	}
+}
+
+void UMapEditorMapCatalog::InvalidateMapList(const FString& MapDirectory)
+{
+	Directories.Remove(GetDirectoryKey(MapDirectory));
+}
+
+void UMapEditorMapCatalog::SaveLevelAsync(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, FMapEditorMapSaveCompleted OnCompleted, bool bCompress)
+{
+	FMapEditorItems MapItems;
+	if (!UMapEditorStatics::GetMapItems(WorldActor, MapItems))
+	{
+		OnCompleted.ExecuteIfBound(false, FString());
+		return;
+	}
+	SaveMapItemsAsync(WorldActor, MapDirectory, MapName, MapItems, OnCompleted, bCompress);
+}
+
+void UMapEditorMapCatalog::SaveMapItemsAsync(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, const FMapEditorItems& MapItems, FMapEditorMapSaveCompleted OnCompleted, bool bCompress)
+{
+	if (!WorldActor || !WorldActor->GetWorld() || MapName.IsEmpty())
+	{
+		OnCompleted.ExecuteIfBound(false, FString());
+		return;
+	}
+
+	// Object paths are gathered here, compression and the write happen on the thread pool
+	FString FullMapName;
+	const FString FilePath = UMapEditorStatics::GetMapFilePath(WorldActor->GetWorld(), MapDirectory, MapName, FullMapName);
+	FMapEditorMapFile File;
+	UMapEditorStatics::EncodeMapItems(MapItems, File);
+	
+	// Saves of the same file run in order, each one is written next to it and moved over it once complete
+	TFuture<void> PreviousSave;
+	if (TFuture<void>* PendingSave = PendingSaves.Find(FilePath))
+	{
+		PreviousSave = MoveTemp(*PendingSave);
+	}
+	
+	TWeakObjectPtr<UMapEditorMapCatalog> WeakThis(this);
+	PendingSaves.Add(FilePath, Async(EAsyncExecution::ThreadPool, [WeakThis, MapDirectory, FilePath, FullMapName, OnCompleted, bCompress, File = MoveTemp(File), PreviousSave = MoveTemp(PreviousSave)]()
+	{
+		if (PreviousSave.IsValid())
+		{
+			PreviousSave.Wait();
+		}
+		
+		TArray<uint8> Data;
+		const FString TempFilePath = FilePath + TEXT(".tmp");
+		const bool bSuccess = UMapEditorStatics::WriteMapFile(File, Data, bCompress) && FFileHelper::SaveArrayToFile(Data, *TempFilePath)
+			&& IFileManager::Get().Move(*FilePath, *TempFilePath, true, true);
+		if (!bSuccess)
+		{
+			IFileManager::Get().Delete(*TempFilePath, false, true, true);
+		}
+		const FMapEditorMapInfo Info = MakeMapInfo(FPaths::GetCleanFilename(FilePath), Data.Num(),
+			bSuccess ? IFileManager::Get().GetTimeStamp(*FilePath) : FDateTime(), File.Records.Num());
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, MapDirectory, FullMapName, OnCompleted, bSuccess, Info]()
+		{
+			UMapEditorMapCatalog* Catalog = WeakThis.Get();
+			if (Catalog && bSuccess)
+			{
+				Catalog->UpdateMap(MapDirectory, Info);
+			}
+			OnCompleted.ExecuteIfBound(bSuccess, FullMapName);
+		});
+	}));
+}
+
+void UMapEditorMapCatalog::LoadMapItemsAsync(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, FMapEditorMapLoadCompleted OnCompleted)
+{
+	if (!WorldActor || !WorldActor->GetWorld() || MapName.IsEmpty())
+	{
+		OnCompleted.ExecuteIfBound(false, FMapEditorItems(), FString());
+		return;
+	}
+
+	// Reading and decompressing happen on the thread pool, only object lookups are left for the game thread
+	FString FullMapName;
+	const FString FilePath = UMapEditorStatics::GetMapFilePath(WorldActor->GetWorld(), MapDirectory, MapName, FullMapName);
+	Async(EAsyncExecution::ThreadPool, [FilePath, FullMapName, OnCompleted]()
+	{
+		TArray<uint8> Data;
+		FMapEditorMapFile File;
+		const bool bDecoded = FFileHelper::LoadFileToArray(Data, *FilePath) && UMapEditorStatics::DecodeMapFile(Data, File);
+
+		AsyncTask(ENamedThreads::GameThread, [FullMapName, OnCompleted, bDecoded, File = MoveTemp(File)]()
+		{
+			FMapEditorItems MapItems;
+			const bool bSuccess = bDecoded && UMapEditorStatics::ResolveMapFile(File, MapItems);
+			OnCompleted.ExecuteIfBound(bSuccess, MapItems, FullMapName);
+		});
+	});
+}
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "MapEditorStatics.h"
 #include "MapEditorInterface.h"
+#include "MapEditorSubsystem.h"
+#include "MapEditorMapCatalog.h"
 
 #include "Kismet/GameplayStatics.h"
 #include "JsonObjectConverter.h"
@@ -10,8 +12,34 @@
 #include "Misc/Paths.h"
 #include "HAL/FileManagerGeneric.h"
 #include "Misc/Base64.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
 #include "Materials/MaterialInterface.h"
 
+// "SKMP", files without it are Base64 encoded json
+static const uint32 MapFileMagic = 0x504D4B53;
+static const uint16 MapFileVersion = 2;
+// Sanity bound for the size stored in the header, so a corrupt file can't request a huge buffer
+static const int32 MapFileMaxUncompressedSize = 1024 * 1024 * 1024;
+
+enum EMapFileFlags : uint8
+{
+	MFF_Compressed = 1 << 0
+};
+
+enum EMapItemFlags : uint8
+{
+	MIF_Rotation = 1 << 0,
+	MIF_Scale = 1 << 1
+};
+
+// Class index, flags, location and the material count
+static const int64 MapItemMinSize = sizeof(int32) + sizeof(uint8) + sizeof(FVector3f) + sizeof(int32);
+
 FString UMapEditorStatics::SerializeLevel(AActor* WorldActor, bool& Success)
 {
 	if (!WorldActor)
@@ -20,43 +48,366 @@ FString UMapEditorStatics::SerializeLevel(AActor* WorldActor, bool& Success)
 		return FString("World Actor Invalid");
 	}
 
-	if (const UWorld* World = WorldActor->GetWorld())
+	FMapEditorItems MapItems;
+	if (GetMapItems(WorldActor, MapItems))
 	{
 		FString SerializedString;
+		Success = FJsonObjectConverter::UStructToJsonObjectString(MapItems, SerializedString);
+		return SerializedString;
+	}
+	Success = false;
+	return FString("Failed");
+}
+
+bool UMapEditorStatics::GetMapItems(AActor* WorldActor, FMapEditorItems& MapItems)
+{
+	if (!WorldActor) return false;
+	
+	if (const UWorld* World = WorldActor->GetWorld())
+	{
 		TArray<AActor*> Actors;
-		UGameplayStatics::GetAllActorsWithInterface(World, UMapEditorInterface::StaticClass(), Actors);
-		FMapEditorItems MapItems;
+		if (const UMapEditorSubsystem* Subsystem = World->GetSubsystem<UMapEditorSubsystem>())
+		{
+			Subsystem->GetEditableActors(Actors);
+		}
+		else
+		{
+			UGameplayStatics::GetAllActorsWithInterface(World, UMapEditorInterface::StaticClass(), Actors);
+		}
+		MapItems.Items.Reserve(MapItems.Items.Num() + Actors.Num());
 		for (const AActor* Actor : Actors)
 		{
-			if (IsValid(Actor))
+			if (IsValid(Actor) && !UMapEditorSubsystem::IsPooled(Actor))
 			{
-				TArray<UMaterialInterface*> Materials;
-				
-				TArray<UActorComponent*> MeshComponents = Actor->GetComponentsByTag(UMeshComponent::StaticClass(), FName("MapEditor"));
-				for (UActorComponent* Component : MeshComponents)
-				{
-					if (const UMeshComponent* MeshComponent = Cast<UMeshComponent>(Component))
-					{
-						const int32 MaterialCount = MeshComponent->GetNumMaterials();
-						for (uint8 i = 0; i < MaterialCount; ++i)
-						{
-							Materials.Add((MeshComponent->GetMaterial(i)));
-						}
-						UE_LOG(LogTemp, Warning, TEXT("Mesh Component Found: %s"), *MeshComponent->GetName());
-						//Materials.Add((MeshComponent->GetMaterial(0)));
-					}
-				}
-				FMapEditorItem Item;
-				Item.ActorToSpawn = Actor->GetClass();
-				Item.ItemTransform = Actor->GetTransform();
-				Item.Materials = Materials;
-				MapItems.Items.Add(Item);
+				MapItems.Items.Add(MakeMapItem(Actor));
 			}
 		}
-		Success = FJsonObjectConverter::UStructToJsonObjectString(MapItems, SerializedString);
-		return SerializedString;
+		return true;
 	}
-	return FString("Failed");
+	return false;
+}
+
+FMapEditorItem UMapEditorStatics::MakeMapItem(const AActor* Actor)
+{
+	FMapEditorItem Item;
+	if (!Actor) return Item;
+	
+	TArray<UMaterialInterface*> Materials;
+	
+	TArray<UActorComponent*> MeshComponents = Actor->GetComponentsByTag(UMeshComponent::StaticClass(), FName("MapEditor"));
+	for (UActorComponent* Component : MeshComponents)
+	{
+		if (const UMeshComponent* MeshComponent = Cast<UMeshComponent>(Component))
+		{
+			const int32 MaterialCount = MeshComponent->GetNumMaterials();
+			for (uint8 i = 0; i < MaterialCount; ++i)
+			{
+				Materials.Add((MeshComponent->GetMaterial(i)));
+			}
+			UE_LOG(LogTemp, Verbose, TEXT("Mesh Component Found: %s"), *MeshComponent->GetName());
+			//Materials.Add((MeshComponent->GetMaterial(0)));
+		}
+	}
+	Item.ActorToSpawn = Actor->GetClass();
+	Item.ItemTransform = Actor->GetTransform();
+	Item.Materials = Materials;
+	return Item;
+}
+
+FIntVector UMapEditorStatics::GetMapCell(const FVector& Location, float CellSize)
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UMapEditorStatics::MakeMapChunks(const FMapEditorItems& MapItems, float CellSize, TArray<FMapEditorMapChunk>& OutChunks)
+{
+	TMap<FIntVector, int32> ChunkIndices;
+	for (const FMapEditorItem& Item : MapItems.Items)
+	{
+		const FIntVector Cell = GetMapCell(Item.ItemTransform.GetLocation(), CellSize);
+		int32& Index = ChunkIndices.FindOrAdd(Cell, INDEX_NONE);
+		if (Index == INDEX_NONE)
+		{
+			Index = OutChunks.AddDefaulted();
+			OutChunks[Index].Cell = Cell;
+		}
+		OutChunks[Index].Items.Add(Item);
+	}
+}
+
+bool UMapEditorStatics::WriteMapItems(const FMapEditorItems& MapItems, TArray<uint8>& OutData, bool bCompress)
+{
+	FMapEditorMapFile File;
+	EncodeMapItems(MapItems, File);
+	return WriteMapFile(File, OutData, bCompress);
+}
+
+void UMapEditorStatics::EncodeMapItems(const FMapEditorItems& MapItems, FMapEditorMapFile& OutFile)
+{
+	// Class and material paths are stored once, items reference them by index
+	TMap<const UObject*, int32> PathIndices;
+	auto GetPathIndex = [&OutFile, &PathIndices](const UObject* Object)
+	{
+		if (!Object) return int32(INDEX_NONE);
+		if (const int32* Index = PathIndices.Find(Object))
+		{
+			return *Index;
+		}
+		const int32 Index = OutFile.Paths.Add(Object->GetPathName());
+		PathIndices.Add(Object, Index);
+		return Index;
+	};
+
+	OutFile.Records.Reset(MapItems.Items.Num());
+	for (const FMapEditorItem& Item : MapItems.Items)
+	{
+		FMapEditorMapRecord& Record = OutFile.Records.AddDefaulted_GetRef();
+		Record.ClassIndex = GetPathIndex(Item.ActorToSpawn.Get());
+		Record.Transform = Item.ItemTransform;
+		Record.MaterialIndices.Reserve(Item.Materials.Num());
+		for (const UMaterialInterface* Material : Item.Materials)
+		{
+			Record.MaterialIndices.Add(GetPathIndex(Material));
+		}
+	}
+}
+
+bool UMapEditorStatics::WriteMapFile(const FMapEditorMapFile& File, TArray<uint8>& OutData, bool bCompress)
+{
+	TArray<uint8> ItemData;
+	FMemoryWriter ItemWriter(ItemData);
+	for (const FMapEditorMapRecord& Record : File.Records)
+	{
+		int32 ClassIndex = Record.ClassIndex;
+
+		// Rotation and scale are left out when they are identity, which most props are
+		FVector3f Location = FVector3f(Record.Transform.GetLocation());
+		FRotator3f Rotation = FRotator3f(Record.Transform.Rotator());
+		FVector3f Scale = FVector3f(Record.Transform.GetScale3D());
+		uint8 Flags = 0;
+		if (!Rotation.IsNearlyZero()) Flags |= MIF_Rotation;
+		if (!Scale.Equals(FVector3f::OneVector)) Flags |= MIF_Scale;
+
+		ItemWriter << ClassIndex;
+		ItemWriter << Flags;
+		ItemWriter << Location;
+		if (Flags & MIF_Rotation) ItemWriter << Rotation;
+		if (Flags & MIF_Scale) ItemWriter << Scale;
+
+		TArray<int32> MaterialIndices = Record.MaterialIndices;
+		ItemWriter << MaterialIndices;
+	}
+
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+	TArray<FString> Paths = File.Paths;
+	int32 ItemNum = File.Records.Num();
+	PayloadWriter << Paths;
+	PayloadWriter << ItemNum;
+	PayloadWriter.Serialize(ItemData.GetData(), ItemData.Num());
+
+	uint32 Magic = MapFileMagic;
+	uint16 Version = MapFileVersion;
+	uint8 Flags = 0;
+	int32 UncompressedSize = Payload.Num();
+	
+	if (bCompress)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Payload.Num());
+		TArray<uint8> Compressed;
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Payload.GetData(), Payload.Num()) && CompressedSize < Payload.Num())
+		{
+			Compressed.SetNum(CompressedSize);
+			Payload = MoveTemp(Compressed);
+			Flags |= MFF_Compressed;
+		}
+	}
+
+	OutData.Reset();
+	FMemoryWriter FileWriter(OutData);
+	FileWriter << Magic;
+	FileWriter << Version;
+	FileWriter << Flags;
+	FileWriter << UncompressedSize;
+	// Version 2, lets the map catalogue count items without reading the payload
+	FileWriter << ItemNum;
+	FileWriter.Serialize(Payload.GetData(), Payload.Num());
+	return !FileWriter.IsError();
+}
+
+bool UMapEditorStatics::ReadMapItems(const TArray<uint8>& Data, FMapEditorItems& OutMapItems)
+{
+	FMapEditorMapFile File;
+	return IsBinaryMap(Data) && DecodeMapFile(Data, File) && ResolveMapFile(File, OutMapItems);
+}
+
+bool UMapEditorStatics::ReadMapHeader(FArchive& Reader, uint16& OutVersion, uint8& OutFlags, int32& OutUncompressedSize, int32& OutItemNum)
+{
+	uint32 Magic = 0;
+	Reader << Magic;
+	if (Reader.IsError() || Magic != MapFileMagic) return false;
+	
+	Reader << OutVersion;
+	Reader << OutFlags;
+	Reader << OutUncompressedSize;
+	OutItemNum = INDEX_NONE;
+	if (OutVersion >= 2)
+	{
+		Reader << OutItemNum;
+	}
+	if (Reader.IsError() || OutVersion > MapFileVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Unsupported map file version: %d"), OutVersion);
+		return false;
+	}
+	if (OutUncompressedSize < 0 || OutUncompressedSize > MapFileMaxUncompressedSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid map file size: %d"), OutUncompressedSize);
+		return false;
+	}
+	return true;
+}
+
+bool UMapEditorStatics::DecodeMapFile(const TArray<uint8>& Data, FMapEditorMapFile& OutFile)
+{
+	if (!IsBinaryMap(Data))
+	{
+		// Maps saved before the binary format
+		FString Dest;
+		FFileHelper::BufferToString(Dest, Data.GetData(), Data.Num());
+		OutFile.LegacyJson = DecodeString(Dest);
+		return !OutFile.LegacyJson.IsEmpty();
+	}
+	
+	FMemoryReader FileReader(Data);
+	uint16 Version = 0;
+	uint8 Flags = 0;
+	int32 UncompressedSize = 0;
+	int32 HeaderItemNum = 0;
+	if (!ReadMapHeader(FileReader, Version, Flags, UncompressedSize, HeaderItemNum)) return false;
+
+	// Uncompressed maps are read in place
+	TArray<uint8> Payload;
+	FMemoryReader PayloadReader(Payload);
+	FArchive& Reader = (Flags & MFF_Compressed) ? static_cast<FArchive&>(PayloadReader) : static_cast<FArchive&>(FileReader);
+	if (Flags & MFF_Compressed)
+	{
+		const int64 HeaderSize = FileReader.Tell();
+		Payload.SetNumUninitialized(UncompressedSize);
+		if (!FCompression::UncompressMemory(NAME_Zlib, Payload.GetData(), UncompressedSize, Data.GetData() + HeaderSize, Data.Num() - HeaderSize))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Failed to decompress map file"));
+			return false;
+		}
+	}
+
+	// Counts read from the file can't ask for more elements than the payload has bytes left
+	Reader.ArMaxSerializeSize = Reader.TotalSize() - Reader.Tell();
+	Reader << OutFile.Paths;
+
+	int32 ItemNum = 0;
+	Reader << ItemNum;
+	if (Reader.IsError() || ItemNum < 0 || ItemNum > (Reader.TotalSize() - Reader.Tell()) / MapItemMinSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid map file item count: %d"), ItemNum);
+		return false;
+	}
+
+	OutFile.Records.Reset(ItemNum);
+	for (int32 i = 0; i < ItemNum && !Reader.IsError(); ++i)
+	{
+		FMapEditorMapRecord& Record = OutFile.Records.AddDefaulted_GetRef();
+		uint8 ItemFlags = 0;
+		FVector3f Location = FVector3f::ZeroVector;
+		FRotator3f Rotation = FRotator3f::ZeroRotator;
+		FVector3f Scale = FVector3f::OneVector;
+		
+		Reader << Record.ClassIndex;
+		Reader << ItemFlags;
+		Reader << Location;
+		if (ItemFlags & MIF_Rotation) Reader << Rotation;
+		if (ItemFlags & MIF_Scale) Reader << Scale;
+		Reader << Record.MaterialIndices;
+		Record.Transform = FTransform(FRotator(Rotation), FVector(Location), FVector(Scale));
+	}
+	return !Reader.IsError();
+}
+
+bool UMapEditorStatics::ResolveMapFile(const FMapEditorMapFile& File, FMapEditorItems& OutMapItems)
+{
+	if (!File.LegacyJson.IsEmpty())
+	{
+		bool bSuccess = false;
+		OutMapItems = DeSerializeLevel(File.LegacyJson, bSuccess);
+		return bSuccess;
+	}
+	
+	// Each path is only resolved once, no matter how many items use it
+	TArray<UObject*> Objects;
+	Objects.Reserve(File.Paths.Num());
+	for (const FString& Path : File.Paths)
+	{
+		Objects.Add(StaticLoadObject(UObject::StaticClass(), nullptr, *Path));
+	}
+	auto GetObject = [&Objects](const int32 Index)
+	{
+		return Objects.IsValidIndex(Index) ? Objects[Index] : nullptr;
+	};
+
+	OutMapItems.Items.Reset(File.Records.Num());
+	for (const FMapEditorMapRecord& Record : File.Records)
+	{
+		FMapEditorItem Item;
+		UClass* ActorClass = Cast<UClass>(GetObject(Record.ClassIndex));
+		Item.ActorToSpawn = ActorClass && ActorClass->IsChildOf(AActor::StaticClass()) ? ActorClass : nullptr;
+		Item.ItemTransform = Record.Transform;
+		Item.Materials.Reserve(Record.MaterialIndices.Num());
+		for (const int32 MaterialIndex : Record.MaterialIndices)
+		{
+			Item.Materials.Add(Cast<UMaterialInterface>(GetObject(MaterialIndex)));
+		}
+		OutMapItems.Items.Add(Item);
+	}
+	return true;
+}
+
+int32 UMapEditorStatics::GetMapFileItemCount(const FMapEditorMapFile& File)
+{
+	if (File.LegacyJson.IsEmpty())
+	{
+		return File.Records.Num();
+	}
+
+	TSharedPtr<FJsonObject> JsonObject;
+	const TArray<TSharedPtr<FJsonValue>>* Items = nullptr;
+	if (FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(File.LegacyJson), JsonObject) && JsonObject.IsValid()
+		&& JsonObject->TryGetArrayField(TEXT("Items"), Items))
+	{
+		return Items->Num();
+	}
+	return INDEX_NONE;
+}
+
+bool UMapEditorStatics::IsBinaryMap(const TArray<uint8>& Data)
+{
+	if (Data.Num() < static_cast<int32>(sizeof(uint32))) return false;
+	
+	uint32 Magic = 0;
+	FMemoryReader Reader(Data);
+	Reader << Magic;
+	return Magic == MapFileMagic;
+}
+
+FString UMapEditorStatics::GetMapFilePath(const UWorld* World, const FString& MapDirectory, const FString& MapName, FString& FullMapName)
+{
+	const FString LevelName = UGameplayStatics::GetCurrentLevelName(World);
+	const FString FileName = FString(LevelName + "&" + MapName + ".skmap");
+	FullMapName = RemoveExtension(FileName);
+	return FString(MapDirectory + "/" + FileName);
 }
 
 FMapEditorItems UMapEditorStatics::DeSerializeLevel(const FString& JsonString, bool& Success)
@@ -73,48 +424,40 @@ FMapEditorItems UMapEditorStatics::DeSerializeLevel(const FString& JsonString, b
 void UMapEditorStatics::SpawnMapItems(AActor* WorldActor, FMapEditorItems MapItems)
 {
 	if (!WorldActor || (WorldActor && !WorldActor->HasAuthority())) return;
-	ClearMap(WorldActor);
 	
+	// Spawning is spread over frames, actors of the current map are reused where possible
 	if (UWorld* World = WorldActor->GetWorld())
 	{
-		for (FMapEditorItem& Item : MapItems.Items)
+		if (UMapEditorSubsystem* Subsystem = World->GetSubsystem<UMapEditorSubsystem>())
 		{
-			if (Item.ActorToSpawn)
+			Subsystem->LoadMap(MapItems);
+		}
+	}
+}
+
+void UMapEditorStatics::ApplyItemMaterials(AActor* Actor, const FMapEditorItem& Item)
+{
+	if (Actor && Item.Materials.Num() && Actor->GetClass()->ImplementsInterface(UMapEditorInterface::StaticClass()))
+	{
+		FMapEditorItemMaterial MapEditorItemMaterial;
+		
+		TArray<UActorComponent*> MeshComponents = Actor->GetComponentsByTag(UMeshComponent::StaticClass(), FName("MapEditor"));
+		MapEditorItemMaterial.MeshComponents.Reserve(MeshComponents.Num());
+		for (UActorComponent* Component : MeshComponents)
+		{
+			if (UMeshComponent* MeshComponent = Cast<UMeshComponent>(Component))
 			{
-				if (AActor* Actor = World->SpawnActor<AActor>(Item.ActorToSpawn))
-				{
-					Actor->SetActorTransform(Item.ItemTransform);
-					
-					if (Actor->GetClass()->ImplementsInterface(UMapEditorInterface::StaticClass()))
-					{
-						if (Item.Materials.Num())
-						{
-							FMapEditorItemMaterial MapEditorItemMaterial;
-							
-							uint8 MaterialIndex = 0;
-							TArray<UActorComponent*> MeshComponents = Actor->GetComponentsByTag(UMeshComponent::StaticClass(), FName("MapEditor"));
-							MapEditorItemMaterial.MeshComponents.Reserve(MeshComponents.Num());
-							for (UActorComponent* Component : MeshComponents)
-							{
-								if (UMeshComponent* MeshComponent = Cast<UMeshComponent>(Component))
-								{
-									MapEditorItemMaterial.MeshComponents.Add(MeshComponent);
-									MapEditorItemMaterial.Materials = Item.Materials;
-								}
-							}
-							IMapEditorInterface::Execute_OnMaterialLoaded(Actor, MapEditorItemMaterial);
-						}
-					}
-				}
+				MapEditorItemMaterial.MeshComponents.Add(MeshComponent);
 			}
 		}
+		MapEditorItemMaterial.Materials = Item.Materials;
+		IMapEditorInterface::Execute_OnMaterialLoaded(Actor, MapEditorItemMaterial);
 	}
 }
 
 void UMapEditorStatics::SpawnMapItemsFromJson(AActor* WorldActor, const FString& JsonString)
 {
 	if (!WorldActor || (WorldActor && !WorldActor->HasAuthority()) && !JsonString.IsEmpty()) return;
-	ClearMap(WorldActor);
 	
 	bool bSuccess = false;
 	const FMapEditorItems MapItems = DeSerializeLevel(JsonString, bSuccess);
@@ -124,16 +467,38 @@ void UMapEditorStatics::SpawnMapItemsFromJson(AActor* WorldActor, const FString&
 void UMapEditorStatics::ClearMap(AActor* WorldActor)
 {
 	if (!WorldActor || (WorldActor && !WorldActor->HasAuthority())) return;
-	if (const UWorld* World = WorldActor->GetWorld())
+	if (UWorld* World = WorldActor->GetWorld())
 	{
+		UMapEditorSubsystem* Subsystem = World->GetSubsystem<UMapEditorSubsystem>();
+		if (Subsystem)
+		{
+			Subsystem->CancelMapLoad();
+			Subsystem->OnMapReset.Broadcast();
+		}
+		
 		TArray<AActor*> Actors;
-		UGameplayStatics::GetAllActorsWithInterface(World, UMapEditorInterface::StaticClass(), Actors);
+		if (Subsystem)
+		{
+			Subsystem->GetEditableActors(Actors);
+		}
+		else
+		{
+			UGameplayStatics::GetAllActorsWithInterface(World, UMapEditorInterface::StaticClass(), Actors);
+		}
 
 		for (AActor* Actor : Actors)
 		{
 			if (Actor)
 			{
-				Actor->Destroy();
+				// Cleared actors are pooled for the next map
+				if (Subsystem)
+				{
+					Subsystem->ReleaseActor(Actor);
+				}
+				else
+				{
+					Actor->Destroy();
+				}
 			}
 		}
 	}
@@ -160,11 +525,24 @@ bool UMapEditorStatics::LoadMapFromFile(AActor* WorldActor, const FString& MapDi
 		const FString LevelName = UGameplayStatics::GetCurrentLevelName(World);
 		const FString FileName = FString(LevelName + "&" + MapName);
 		const FString FilePath = FString(MapDirectory + "/" + FileName + Extension);
-		FString Dest;
 		FullMapName = RemoveExtension(FileName);
-		const bool Successful = FFileHelper::LoadFileToString(Dest, *FilePath);
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *FilePath))
+		{
+			return false;
+		}
+
+		// Binary maps are converted so callers still get json
+		if (IsBinaryMap(Data))
+		{
+			FMapEditorItems MapItems;
+			return ReadMapItems(Data, MapItems) && FJsonObjectConverter::UStructToJsonObjectString(MapItems, OutString);
+		}
+		
+		FString Dest;
+		FFileHelper::BufferToString(Dest, Data.GetData(), Data.Num());
 		OutString = DecodeString(Dest);
-		return Successful;
+		return true;
 	}
 	return false;
 }
@@ -175,11 +553,68 @@ bool UMapEditorStatics::SaveMapToFile(AActor* WorldActor, const FString& MapDire
 	
 	if (const UWorld* World = WorldActor->GetWorld())
 	{
-		const FString LevelName = UGameplayStatics::GetCurrentLevelName(World);
-		const FString FileName = FString(LevelName + "&" + MapName + ".skmap");
-		const FString FilePath = FString(MapDirectory + "/" + FileName);
-		FullMapName = RemoveExtension(FileName);
-		return FFileHelper::SaveStringToFile(EncodeString(StringToSave), *FilePath);
+		bool bSuccess = false;
+		const FMapEditorItems MapItems = DeSerializeLevel(StringToSave, bSuccess);
+		if (bSuccess)
+		{
+			return SaveMapItemsToFile(WorldActor, MapDirectory, MapName, MapItems, FullMapName);
+		}
+		
+		const FString FilePath = GetMapFilePath(World, MapDirectory, MapName, FullMapName);
+		if (FFileHelper::SaveStringToFile(EncodeString(StringToSave), *FilePath))
+		{
+			// The item count of a string that is not map json is unknown
+			if (UMapEditorMapCatalog* Catalog = UMapEditorMapCatalog::Get(WorldActor))
+			{
+				Catalog->UpdateMap(MapDirectory, UMapEditorMapCatalog::MakeMapInfo(FPaths::GetCleanFilename(FilePath), IFileManager::Get().FileSize(*FilePath), IFileManager::Get().GetTimeStamp(*FilePath), INDEX_NONE));
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UMapEditorStatics::SaveLevelToFile(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, FString& FullMapName, bool bCompress)
+{
+	FMapEditorItems MapItems;
+	if (MapName.IsEmpty() || !GetMapItems(WorldActor, MapItems)) return false;
+	
+	return SaveMapItemsToFile(WorldActor, MapDirectory, MapName, MapItems, FullMapName, bCompress);
+}
+
+bool UMapEditorStatics::SaveMapItemsToFile(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, const FMapEditorItems& MapItems, FString& FullMapName, bool bCompress)
+{
+	if (!WorldActor || MapName.IsEmpty()) return false;
+	
+	if (const UWorld* World = WorldActor->GetWorld())
+	{
+		TArray<uint8> Data;
+		if (WriteMapItems(MapItems, Data, bCompress))
+		{
+			const FString FilePath = GetMapFilePath(World, MapDirectory, MapName, FullMapName);
+			if (FFileHelper::SaveArrayToFile(Data, *FilePath))
+			{
+				if (UMapEditorMapCatalog* Catalog = UMapEditorMapCatalog::Get(WorldActor))
+				{
+					Catalog->UpdateMap(MapDirectory, UMapEditorMapCatalog::MakeMapInfo(FPaths::GetCleanFilename(FilePath), Data.Num(), IFileManager::Get().GetTimeStamp(*FilePath), MapItems.Items.Num()));
+				}
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool UMapEditorStatics::LoadMapItemsFromFile(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, FMapEditorItems& MapItems, FString& FullMapName)
+{
+	if (!WorldActor || MapName.IsEmpty()) return false;
+	
+	if (const UWorld* World = WorldActor->GetWorld())
+	{
+		const FString FilePath = GetMapFilePath(World, MapDirectory, MapName, FullMapName);
+		TArray<uint8> Data;
+		FMapEditorMapFile File;
+		return FFileHelper::LoadFileToArray(Data, *FilePath) && DecodeMapFile(Data, File) && ResolveMapFile(File, MapItems);
 	}
 	return false;
 }
@@ -198,6 +633,26 @@ bool UMapEditorStatics::DoesMapExist(AActor* WorldActor, const FString& MapDirec
 	return false;
 }
 
+bool UMapEditorStatics::DeleteMap(AActor* WorldActor, const FString& MapDirectory, const FString& MapName)
+{
+	if (!WorldActor || MapName.IsEmpty()) return false;
+	
+	if (const UWorld* World = WorldActor->GetWorld())
+	{
+		FString FullMapName;
+		const FString FilePath = GetMapFilePath(World, MapDirectory, MapName, FullMapName);
+		if (IFileManager::Get().Delete(*FilePath))
+		{
+			if (UMapEditorMapCatalog* Catalog = UMapEditorMapCatalog::Get(WorldActor))
+			{
+				Catalog->RemoveMap(MapDirectory, FPaths::GetCleanFilename(FilePath));
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
 FString UMapEditorStatics::GetRealMapName(const FString& MapName)
 {
 	int32 Index = MapName.Find("&");
@@ -212,6 +667,20 @@ FString UMapEditorStatics::GetRealMapName(const FString& MapName)
 
 TArray<FString> UMapEditorStatics::GetMapList(AActor* WorldActor, const FString& MapDirectory, bool bCutLevelname, bool bShowAllMaps)
 {
+	// Once the catalogue has scanned the directory the disk is not touched again, RefreshMapList picks up files changed by other programs
+	const UMapEditorMapCatalog* Catalog = UMapEditorMapCatalog::Get(WorldActor);
+	if (Catalog && Catalog->HasMapList(MapDirectory))
+	{
+		const UWorld* World = WorldActor->GetWorld();
+		const FString LevelName = World && !bShowAllMaps ? UGameplayStatics::GetCurrentLevelName(World) : FString();
+		TArray<FString> FileNames;
+		for (const FMapEditorMapInfo& Info : Catalog->GetMapList(MapDirectory, LevelName))
+		{
+			FileNames.Add(bCutLevelname ? GetRealMapName(Info.FileName) : Info.FileName);
+		}
+		return FileNames;
+	}
+	
 	FString FilesDirectory = *(MapDirectory + "/");
 	if (FPaths::DirectoryExists(FilesDirectory))
 	{
@@ -251,13 +720,7 @@ FString UMapEditorStatics::RemoveExtension(const FString& String)
 
 void UMapEditorStatics::StripInvalidMaps(const FString& WorldName, TArray<FString>& MapList)
 {
-	for (uint8 i = 0; i < MapList.Num(); ++i)
-	{
-		if (!MapList[i].Contains(WorldName))
-		{
-			MapList.RemoveSingle(MapList[i]);
-		}
-	}
+	MapList.RemoveAll([&WorldName](const FString& MapName) { return !MapName.Contains(WorldName); });
 	MapList.Shrink();
 }
 
@@ -0,0 +1,26 @@
+// Copyright 2021, Dakota Dawe, All rights reserved
+
+
+#include "MapEditorStreamingCell.h"
+#include "MapEditorSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameNetworkManager.h"
+
+AMapEditorStreamingCell::AMapEditorStreamingCell()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	SetReplicates(false);
+	Cell = FIntVector::ZeroValue;
+	Bounds = FBox(ForceInit);
+	NetCullDistanceSquared = 0.0f;
+}
+
+bool AMapEditorStreamingCell::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	const UMapEditorSubsystem* Subsystem = GetWorld() ? GetWorld()->GetSubsystem<UMapEditorSubsystem>() : nullptr;
+	if (Subsystem && !Subsystem->IsCellRelevantFor(Cell, RealViewer)) return false;
+
+	// An actor of the cell can only be within its cull distance if the cell is
+	return !GetDefault<AGameNetworkManager>()->bUseDistanceBasedRelevancy || !Bounds.IsValid || Bounds.ComputeSquaredDistanceToPoint(SrcLocation) < NetCullDistanceSquared;
+}
\ No newline at end of file
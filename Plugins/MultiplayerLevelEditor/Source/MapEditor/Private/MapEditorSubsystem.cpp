@@ -0,0 +1,750 @@
+// Copyright 2021, Dakota Dawe, All rights reserved
+
+
+#include "MapEditorSubsystem.h"
+#include "MapEditorInterface.h"
+#include "MapEditorStatics.h"
+#include "MapEditorStreamingCell.h"
+
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+
+const FName UMapEditorSubsystem::PooledTag = FName("MapEditorPooled");
+
+UMapEditorSubsystem::UMapEditorSubsystem()
+{
+	PendingIndex = 0;
+	bLoadingMap = false;
+
+	SpawnTimeBudget = 4.0f;
+	MaxPooledActorsPerClass = 64;
+	IndexCellSize = 2000.0f;
+	StreamCellSize = 8000.0f;
+	StreamBytesPerSecond = 512.0f * 1024.0f;
+	StreamBytesPerActor = 128;
+}
+
+void UMapEditorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	if (UWorld* World = GetWorld())
+	{
+		ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UMapEditorSubsystem::OnActorSpawned));
+	}
+	PostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &UMapEditorSubsystem::OnPostLogin);
+	LogoutHandle = FGameModeEvents::GameModeLogoutEvent.AddUObject(this, &UMapEditorSubsystem::OnLogout);
+}
+
+void UMapEditorSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Actors placed in the level never go through the spawn handler
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		if (It->Implements<UMapEditorInterface>())
+		{
+			RegisterActor(*It);
+		}
+	}
+}
+
+bool UMapEditorSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMapEditorSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	FGameModeEvents::GameModePostLoginEvent.Remove(PostLoginHandle);
+	FGameModeEvents::GameModeLogoutEvent.Remove(LogoutHandle);
+	StreamingCells.Empty();
+	ClientStreams.Empty();
+	PlayerBudgets.Empty();
+	
+	for (TPair<TWeakObjectPtr<AActor>, FMapEditorIndexEntry>& Indexed : IndexedActors)
+	{
+		if (AActor* Actor = Indexed.Key.Get())
+		{
+			Actor->OnDestroyed.RemoveDynamic(this, &UMapEditorSubsystem::OnIndexedActorDestroyed);
+			if (USceneComponent* Root = Actor->GetRootComponent())
+			{
+				Root->TransformUpdated.RemoveAll(this);
+			}
+		}
+	}
+	IndexedActors.Empty();
+	Cells.Empty();
+	
+	PendingItems.Empty();
+	ReusableActors.Empty();
+	ActorPool.Empty();
+	bLoadingMap = false;
+	Super::Deinitialize();
+}
+
+TStatId UMapEditorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMapEditorSubsystem, STATGROUP_Tickables);
+}
+
+void UMapEditorSubsystem::LoadMap(const FMapEditorItems& MapItems)
+{
+	UWorld* World = GetWorld();
+	if (!World || World->GetNetMode() == NM_Client) return;
+
+	CancelMapLoad();
+	OnMapReset.Broadcast();
+
+	// Existing actors are kept up to the number of each class the new map needs, the rest go to the pool
+	TMap<UClass*, int32> NeededActors;
+	for (const FMapEditorItem& Item : MapItems.Items)
+	{
+		if (Item.ActorToSpawn)
+		{
+			++NeededActors.FindOrAdd(Item.ActorToSpawn.Get());
+		}
+	}
+
+	TArray<AActor*> Actors;
+	GetEditableActors(Actors);
+	for (AActor* Actor : Actors)
+	{
+
+		int32* Needed = NeededActors.Find(Actor->GetClass());
+		if (Needed && *Needed > 0)
+		{
+			--*Needed;
+			ReusableActors.FindOrAdd(Actor->GetClass()).Add(Actor);
+		}
+		else
+		{
+			ReleaseActor(Actor);
+		}
+	}
+
+	// Items are placed cell by cell, closest to the local view first
+	TArray<FMapEditorMapChunk> Chunks;
+	UMapEditorStatics::MakeMapChunks(MapItems, StreamCellSize, Chunks);
+	FVector ViewLocation = FVector::ZeroVector;
+	if (APlayerController* PC = World->GetFirstPlayerController())
+	{
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	}
+	const float CellSize = StreamCellSize;
+	Chunks.Sort([&ViewLocation, CellSize](const FMapEditorMapChunk& A, const FMapEditorMapChunk& B)
+	{
+		return FVector::DistSquared(A.GetCenter(CellSize), ViewLocation) < FVector::DistSquared(B.GetCenter(CellSize), ViewLocation);
+	});
+
+	PendingItems.Reset(MapItems.Items.Num());
+	for (FMapEditorMapChunk& Chunk : Chunks)
+	{
+		PendingItems.Append(MoveTemp(Chunk.Items));
+	}
+	PendingIndex = 0;
+	bLoadingMap = true;
+
+	if (!PendingItems.Num())
+	{
+		FinishMapLoad();
+	}
+}
+
+void UMapEditorSubsystem::CancelMapLoad()
+{
+	PendingItems.Empty();
+	PendingIndex = 0;
+	ReusableActors.Empty();
+	bLoadingMap = false;
+}
+
+void UMapEditorSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (bLoadingMap)
+	{
+		TickMapLoad();
+	}
+	if (IsStreamingToClients())
+	{
+		TickClientStreams(DeltaTime);
+	}
+}
+
+void UMapEditorSubsystem::TickMapLoad()
+{
+	// At least one item is placed per frame so a load always finishes
+	const double EndTime = FPlatformTime::Seconds() + SpawnTimeBudget / 1000.0f;
+	do
+	{
+		const FMapEditorItem& Item = PendingItems[PendingIndex++];
+		if (Item.ActorToSpawn)
+		{
+			if (AActor* Actor = AcquireActor(Item.ActorToSpawn, Item.ItemTransform))
+			{
+				UMapEditorStatics::ApplyItemMaterials(Actor, Item);
+			}
+		}
+	}
+	while (PendingIndex < PendingItems.Num() && FPlatformTime::Seconds() < EndTime);
+
+	OnMapLoadProgress.Broadcast(PendingIndex, PendingItems.Num());
+
+	if (PendingIndex >= PendingItems.Num())
+	{
+		FinishMapLoad();
+	}
+}
+
+void UMapEditorSubsystem::FinishMapLoad()
+{
+	// Anything not claimed by the new map is pooled
+	for (TPair<TWeakObjectPtr<UClass>, TArray<TWeakObjectPtr<AActor>>>& Reusable : ReusableActors)
+	{
+		for (TWeakObjectPtr<AActor>& Actor : Reusable.Value)
+		{
+			ReleaseActor(Actor.Get());
+		}
+	}
+
+	CancelMapLoad();
+	OnMapLoaded.Broadcast();
+}
+
+AActor* UMapEditorSubsystem::AcquireActor(UClass* ActorClass, const FTransform& Transform)
+{
+	if (TArray<TWeakObjectPtr<AActor>>* Actors = ReusableActors.Find(ActorClass))
+	{
+		while (Actors->Num())
+		{
+			if (AActor* Actor = Actors->Pop(false).Get())
+			{
+				Actor->SetActorTransform(Transform);
+				return Actor;
+			}
+		}
+	}
+
+	if (TArray<TWeakObjectPtr<AActor>>* PooledActors = ActorPool.Find(ActorClass))
+	{
+		while (PooledActors->Num())
+		{
+			if (AActor* Actor = PooledActors->Pop(false).Get())
+			{
+				Actor->Tags.Remove(PooledTag);
+				Actor->SetActorTransform(Transform);
+				Actor->SetActorHiddenInGame(false);
+				Actor->SetActorEnableCollision(true);
+				UpdateStreamingCell(Actor);
+				return Actor;
+			}
+		}
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AActor>(ActorClass, Transform, SpawnParams);
+}
+
+void UMapEditorSubsystem::ReleaseActor(AActor* Actor)
+{
+	if (!IsValid(Actor) || IsPooled(Actor)) return;
+
+	TArray<TWeakObjectPtr<AActor>>& PooledActors = ActorPool.FindOrAdd(Actor->GetClass());
+	PooledActors.RemoveAllSwap([](const TWeakObjectPtr<AActor>& PooledActor) { return !PooledActor.IsValid(); }, false);
+
+	if (PooledActors.Num() >= MaxPooledActorsPerClass)
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	// Pooled actors leave their cell so their own hidden check keeps them from replicating
+	Actor->Tags.Add(PooledTag);
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	RemoveFromStreamingCell(Actor);
+	PooledActors.Add(Actor);
+}
+
+void UMapEditorSubsystem::ClearPool()
+{
+	for (TPair<TWeakObjectPtr<UClass>, TArray<TWeakObjectPtr<AActor>>>& Pool : ActorPool)
+	{
+		for (TWeakObjectPtr<AActor>& Actor : Pool.Value)
+		{
+			if (Actor.IsValid())
+			{
+				Actor->Destroy();
+			}
+		}
+	}
+	ActorPool.Empty();
+}
+
+FIntVector UMapEditorSubsystem::GetCell(const FVector& Location) const
+{
+	return UMapEditorStatics::GetMapCell(Location, IndexCellSize);
+}
+
+void UMapEditorSubsystem::InsertIntoCells(AActor* Actor, const FMapEditorIndexEntry& Entry)
+{
+	for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+	{
+		for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+		{
+			for (int32 Z = Entry.MinCell.Z; Z <= Entry.MaxCell.Z; ++Z)
+			{
+				Cells.FindOrAdd(FIntVector(X, Y, Z)).Add(Actor);
+			}
+		}
+	}
+}
+
+void UMapEditorSubsystem::RemoveFromCells(AActor* Actor, const FMapEditorIndexEntry& Entry)
+{
+	for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+	{
+		for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+		{
+			for (int32 Z = Entry.MinCell.Z; Z <= Entry.MaxCell.Z; ++Z)
+			{
+				const FIntVector Cell(X, Y, Z);
+				if (TArray<TWeakObjectPtr<AActor>>* CellActors = Cells.Find(Cell))
+				{
+					CellActors->RemoveSingleSwap(Actor, false);
+					if (!CellActors->Num())
+					{
+						Cells.Remove(Cell);
+					}
+				}
+			}
+		}
+	}
+}
+
+void UMapEditorSubsystem::RegisterActor(AActor* Actor)
+{
+	if (!IsValid(Actor) || IndexedActors.Contains(Actor)) return;
+
+	IndexedActors.Add(Actor);
+	UpdateActor(Actor);
+	
+	Actor->OnDestroyed.AddUniqueDynamic(this, &UMapEditorSubsystem::OnIndexedActorDestroyed);
+	if (USceneComponent* Root = Actor->GetRootComponent())
+	{
+		Root->TransformUpdated.AddUObject(this, &UMapEditorSubsystem::OnActorTransformUpdated);
+	}
+}
+
+void UMapEditorSubsystem::UnregisterActor(AActor* Actor)
+{
+	FMapEditorIndexEntry Entry;
+	if (!Actor || !IndexedActors.RemoveAndCopyValue(Actor, Entry)) return;
+
+	RemoveFromCells(Actor, Entry);
+	RemoveFromStreamingCell(Actor);
+	Actor->OnDestroyed.RemoveDynamic(this, &UMapEditorSubsystem::OnIndexedActorDestroyed);
+	if (USceneComponent* Root = Actor->GetRootComponent())
+	{
+		Root->TransformUpdated.RemoveAll(this);
+	}
+}
+
+void UMapEditorSubsystem::UpdateActor(AActor* Actor)
+{
+	FMapEditorIndexEntry* Entry = Actor ? IndexedActors.Find(Actor) : nullptr;
+	if (!Entry) return;
+	UpdateStreamingCell(Actor);
+
+	FBox Bounds = Actor->GetComponentsBoundingBox(true);
+	if (!Bounds.IsValid)
+	{
+		Bounds = FBox(Actor->GetActorLocation(), Actor->GetActorLocation());
+	}
+
+	// Moving inside the same cells only needs the new bounds
+	const FIntVector MinCell = GetCell(Bounds.Min);
+	const FIntVector MaxCell = GetCell(Bounds.Max);
+	const bool bWasInserted = Entry->Bounds.IsValid;
+	Entry->Bounds = Bounds;
+	if (bWasInserted && MinCell == Entry->MinCell && MaxCell == Entry->MaxCell) return;
+
+	if (bWasInserted)
+	{
+		RemoveFromCells(Actor, *Entry);
+	}
+	Entry->MinCell = MinCell;
+	Entry->MaxCell = MaxCell;
+	InsertIntoCells(Actor, *Entry);
+}
+
+void UMapEditorSubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (Actor && Actor->Implements<UMapEditorInterface>())
+	{
+		RegisterActor(Actor);
+	}
+}
+
+void UMapEditorSubsystem::OnActorTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateFlags, ETeleportType Teleport)
+{
+	if (Component)
+	{
+		UpdateActor(Component->GetOwner());
+	}
+}
+
+void UMapEditorSubsystem::OnIndexedActorDestroyed(AActor* Actor)
+{
+	UnregisterActor(Actor);
+}
+
+void UMapEditorSubsystem::GetEditableActors(TArray<AActor*>& OutActors) const
+{
+	OutActors.Reserve(OutActors.Num() + IndexedActors.Num());
+	for (const TPair<TWeakObjectPtr<AActor>, FMapEditorIndexEntry>& Indexed : IndexedActors)
+	{
+		AActor* Actor = Indexed.Key.Get();
+		if (IsValid(Actor) && !IsPooled(Actor))
+		{
+			OutActors.Add(Actor);
+		}
+	}
+}
+
+void UMapEditorSubsystem::GetActorsInBox(const FBox& Box, TArray<AActor*>& OutActors) const
+{
+	const FIntVector MinCell = GetCell(Box.Min);
+	const FIntVector MaxCell = GetCell(Box.Max);
+
+	// Huge boxes are cheaper to answer from the actor list than cell by cell
+	const int64 NumCells = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+	if (NumCells > Cells.Num())
+	{
+		for (const TPair<TWeakObjectPtr<AActor>, FMapEditorIndexEntry>& Indexed : IndexedActors)
+		{
+			AActor* Actor = Indexed.Key.Get();
+			if (IsValid(Actor) && !IsPooled(Actor) && Box.Intersect(Indexed.Value.Bounds))
+			{
+				OutActors.Add(Actor);
+			}
+		}
+		return;
+	}
+
+	TSet<AActor*> Found;
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<TWeakObjectPtr<AActor>>* CellActors = Cells.Find(FIntVector(X, Y, Z));
+				if (!CellActors) continue;
+				
+				for (const TWeakObjectPtr<AActor>& WeakActor : *CellActors)
+				{
+					AActor* Actor = WeakActor.Get();
+					if (!IsValid(Actor) || IsPooled(Actor) || Found.Contains(Actor)) continue;
+
+					const FMapEditorIndexEntry* Entry = IndexedActors.Find(Actor);
+					if (Entry && Box.Intersect(Entry->Bounds))
+					{
+						Found.Add(Actor);
+						OutActors.Add(Actor);
+					}
+				}
+			}
+		}
+	}
+}
+
+bool UMapEditorSubsystem::PickActor(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, FHitResult& OutHit, const AActor* IgnoredActor) const
+{
+	const FVector Segment = End - Start;
+	const double Length = Segment.Size();
+	if (Length <= KINDA_SMALL_NUMBER) return false;
+	const FVector Direction = Segment / Length;
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(MapEditorPick), true, IgnoredActor);
+	TSet<AActor*> Tested;
+	double BestDistance = Length;
+	bool bHit = false;
+
+	// Walk the cells along the segment in order, stopping once a hit is closer than the next cell
+	FIntVector Cell = GetCell(Start);
+	const FIntVector EndCell = GetCell(End);
+	FIntVector Step;
+	FVector NextBoundary;
+	FVector BoundaryStep;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const double Dir = Direction[Axis];
+		Step[Axis] = Dir > 0.0f ? 1 : (Dir < 0.0f ? -1 : 0);
+		if (Step[Axis] == 0)
+		{
+			NextBoundary[Axis] = BIG_NUMBER;
+			BoundaryStep[Axis] = BIG_NUMBER;
+			continue;
+		}
+		const double Boundary = (Cell[Axis] + (Step[Axis] > 0 ? 1 : 0)) * IndexCellSize;
+		NextBoundary[Axis] = (Boundary - Start[Axis]) / Dir;
+		BoundaryStep[Axis] = IndexCellSize / FMath::Abs(Dir);
+	}
+
+	while (true)
+	{
+		if (const TArray<TWeakObjectPtr<AActor>>* CellActors = Cells.Find(Cell))
+		{
+			for (const TWeakObjectPtr<AActor>& WeakActor : *CellActors)
+			{
+				AActor* Actor = WeakActor.Get();
+				if (!IsValid(Actor) || Actor == IgnoredActor || IsPooled(Actor) || Tested.Contains(Actor)) continue;
+				Tested.Add(Actor);
+
+				const FMapEditorIndexEntry* Entry = IndexedActors.Find(Actor);
+				if (!Entry || !FMath::LineBoxIntersection(Entry->Bounds, Start, Start + Direction * BestDistance, Direction * BestDistance)) continue;
+
+				FHitResult Hit;
+				if (Actor->ActorLineTraceSingle(Hit, Start, Start + Direction * BestDistance, TraceChannel, Params))
+				{
+					BestDistance = Hit.Distance;
+					OutHit = Hit;
+					bHit = true;
+				}
+			}
+		}
+
+		const double CellExit = FMath::Min3(NextBoundary.X, NextBoundary.Y, NextBoundary.Z);
+		if (Cell == EndCell || CellExit > BestDistance) break;
+
+		const int32 Axis = CellExit == NextBoundary.X ? 0 : (CellExit == NextBoundary.Y ? 1 : 2);
+		Cell[Axis] += Step[Axis];
+		NextBoundary[Axis] += BoundaryStep[Axis];
+	}
+
+	// Anything in front of the picked actor that isn't part of the map, like walls, blocks the pick
+	if (bHit && GetWorld())
+	{
+		Params.AddIgnoredActor(OutHit.GetActor());
+		FHitResult BlockingHit;
+		if (GetWorld()->LineTraceSingleByChannel(BlockingHit, Start, Start + Direction * BestDistance, TraceChannel, Params))
+		{
+			AActor* HitActor = BlockingHit.GetActor();
+			if (!HitActor || IsPooled(HitActor) || !IndexedActors.Contains(HitActor))
+			{
+				return false;
+			}
+		}
+	}
+	return bHit;
+}
+
+void UMapEditorSubsystem::UpdateStreamingCell(AActor* Actor)
+{
+	const UWorld* World = GetWorld();
+	if (!World || World->GetNetMode() == NM_Client || World->GetNetMode() == NM_Standalone || !Actor->GetIsReplicated() || IsPooled(Actor)) return;
+
+	// Actors owned by something else keep their own relevancy
+	AMapEditorStreamingCell* CurrentCell = Cast<AMapEditorStreamingCell>(Actor->GetOwner());
+	if (!CurrentCell && Actor->GetOwner()) return;
+
+	const FIntVector Cell = UMapEditorStatics::GetMapCell(Actor->GetActorLocation(), StreamCellSize);
+	if (CurrentCell && CurrentCell->Cell == Cell) return;
+
+	AMapEditorStreamingCell* NewCell = StreamingCells.FindRef(Cell).Get();
+	if (!NewCell)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		NewCell = GetWorld()->SpawnActor<AMapEditorStreamingCell>(SpawnParams);
+		if (!NewCell) return;
+		NewCell->Cell = Cell;
+		NewCell->Bounds = FBox(FVector(Cell) * StreamCellSize, FVector(Cell + FIntVector(1)) * StreamCellSize);
+		StreamingCells.Add(Cell, NewCell);
+	}
+
+	RemoveFromStreamingCell(Actor);
+	NewCell->Actors.Add(Actor);
+	NewCell->NetCullDistanceSquared = FMath::Max(NewCell->NetCullDistanceSquared, Actor->NetCullDistanceSquared);
+	Actor->bNetUseOwnerRelevancy = true;
+	Actor->SetOwner(NewCell);
+}
+
+void UMapEditorSubsystem::RemoveFromStreamingCell(AActor* Actor)
+{
+	if (AMapEditorStreamingCell* CurrentCell = Cast<AMapEditorStreamingCell>(Actor->GetOwner()))
+	{
+		CurrentCell->Actors.RemoveSingleSwap(Actor, false);
+		Actor->bNetUseOwnerRelevancy = false;
+		Actor->SetOwner(nullptr);
+	}
+}
+
+void UMapEditorSubsystem::OnPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+	if (!GameMode || GameMode->GetWorld() != GetWorld() || !NewPlayer || NewPlayer->IsLocalController()) return;
+
+	// Clients joining an empty map get every later edit through normal replication
+	FMapEditorClientStream& Stream = ClientStreams.Add(NewPlayer);
+	Stream.PlayerController = NewPlayer;
+	Stream.bSynced = StreamingCells.Num() == 0;
+}
+
+void UMapEditorSubsystem::OnLogout(AGameModeBase* GameMode, AController* Exiting)
+{
+	ClientStreams.Remove(Exiting);
+	PlayerBudgets.Remove(Exiting);
+}
+
+bool UMapEditorSubsystem::IsStreamingToClients() const
+{
+	for (const TPair<TWeakObjectPtr<const AActor>, FMapEditorClientStream>& Stream : ClientStreams)
+	{
+		if (!Stream.Value.bSynced)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UMapEditorSubsystem::TickClientStreams(float DeltaTime)
+{
+	const float BytesPerActor = FMath::Max(StreamBytesPerActor, 1);
+	for (auto It = ClientStreams.CreateIterator(); It; ++It)
+	{
+		FMapEditorClientStream& Stream = It.Value();
+		APlayerController* PC = Stream.PlayerController.Get();
+		if (!PC)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		if (Stream.bSynced) continue;
+
+		// Unused budget carries over for up to a second
+		Stream.ByteBudget = FMath::Min(Stream.ByteBudget + StreamBytesPerSecond * DeltaTime, FMath::Max(StreamBytesPerSecond, BytesPerActor));
+		if (Stream.ByteBudget <= 0.0f) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		TArray<AMapEditorStreamingCell*> PendingCells;
+		for (const TPair<FIntVector, TWeakObjectPtr<AMapEditorStreamingCell>>& Cell : StreamingCells)
+		{
+			if (Cell.Value.IsValid() && !Stream.ReleasedCells.Contains(Cell.Key))
+			{
+				PendingCells.Add(Cell.Value.Get());
+			}
+		}
+		const float CellSize = StreamCellSize;
+		PendingCells.Sort([&ViewLocation, CellSize](const AMapEditorStreamingCell& A, const AMapEditorStreamingCell& B)
+		{
+			return FVector::DistSquared((FVector(A.Cell) + FVector(0.5f)) * CellSize, ViewLocation)
+				< FVector::DistSquared((FVector(B.Cell) + FVector(0.5f)) * CellSize, ViewLocation);
+		});
+
+		// Closest cells first, the actors of a released cell become relevant on the next net update
+		int32 CellIndex = 0;
+		for (; CellIndex < PendingCells.Num() && Stream.ByteBudget > 0.0f; ++CellIndex)
+		{
+			AMapEditorStreamingCell* Cell = PendingCells[CellIndex];
+			Stream.ReleasedCells.Add(Cell->Cell);
+			for (const TWeakObjectPtr<AActor>& Actor : Cell->Actors)
+			{
+				if (Actor.IsValid())
+				{
+					Actor->ForceNetUpdate();
+				}
+			}
+			Stream.ByteBudget -= Cell->Actors.Num() * BytesPerActor;
+		}
+
+		if (CellIndex >= PendingCells.Num())
+		{
+			Stream.bSynced = true;
+			Stream.ReleasedCells.Empty();
+			OnClientMapSynced.Broadcast(PC);
+		}
+	}
+}
+
+bool UMapEditorSubsystem::IsCellRelevantFor(const FIntVector& Cell, const AActor* Viewer) const
+{
+	const FMapEditorClientStream* Stream = ClientStreams.Find(Viewer);
+	return !Stream || Stream->bSynced || Stream->ReleasedCells.Contains(Cell);
+}
+
+bool UMapEditorSubsystem::IsClientSynced(const APlayerController* PlayerController) const
+{
+	const FMapEditorClientStream* Stream = ClientStreams.Find(PlayerController);
+	return !Stream || Stream->bSynced;
+}
+
+bool UMapEditorSubsystem::IsClassAllowed(const UClass* ActorClass) const
+{
+	if (!ActorClass || !ActorClass->IsChildOf(AActor::StaticClass()) || !ActorClass->ImplementsInterface(UMapEditorInterface::StaticClass())) return false;
+	if (!EditLimits.AllowedClasses.Num()) return true;
+
+	for (const TSubclassOf<AActor>& AllowedClass : EditLimits.AllowedClasses)
+	{
+		if (AllowedClass && ActorClass->IsChildOf(AllowedClass))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UMapEditorSubsystem::IsInEditBounds(const FVector& Location) const
+{
+	return !EditLimits.EditBounds.IsValid || EditLimits.EditBounds.IsInsideOrOn(Location);
+}
+
+FTransform UMapEditorSubsystem::ClampToEditLimits(const FTransform& Transform) const
+{
+	FTransform Result = Transform;
+	if (EditLimits.EditBounds.IsValid)
+	{
+		Result.SetLocation(EditLimits.EditBounds.GetClosestPointTo(Transform.GetLocation()));
+	}
+	if (EditLimits.MaxScale > 0.0f)
+	{
+		Result.SetScale3D(Transform.GetScale3D().BoundToCube(EditLimits.MaxScale));
+	}
+	return Result;
+}
+
+int32 UMapEditorSubsystem::GetNumMapActors() const
+{
+	// Pool entries of destroyed actors are only pruned on the next release, they are not in the index anymore
+	int32 NumPooled = 0;
+	for (const TPair<TWeakObjectPtr<UClass>, TArray<TWeakObjectPtr<AActor>>>& Pool : ActorPool)
+	{
+		for (const TWeakObjectPtr<AActor>& Actor : Pool.Value)
+		{
+			if (Actor.IsValid() && IndexedActors.Contains(Actor.Get()))
+			{
+				++NumPooled;
+			}
+		}
+	}
+	return FMath::Max(IndexedActors.Num() - NumPooled, 0);
+}
+
+bool UMapEditorSubsystem::IsBelowActorCap(int32 NumNewActors) const
+{
+	return EditLimits.MaxMapActors <= 0 || GetNumMapActors() + NumNewActors <= EditLimits.MaxMapActors;
+}
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include "Components/ActorComponent.h"
 #include "MapEditorHandlerComponent.generated.h"
 
+class UMapEditorSubsystem;
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class MAPEDITOR_API UMapEditorHandlerComponent : public UActorComponent
 {
@@ -26,21 +28,90 @@ protected:
 	TSubclassOf<AMapEditorGizmo> GizmoClass;
 	UPROPERTY(EditDefaultsOnly, Category = "MapEditor")
 	float ReplicationRate;
+	// Changes smaller than this, or than half a snap step, are not sent while dragging
+	UPROPERTY(EditDefaultsOnly, Category = "MapEditor | Replication")
+	FMapEditorSnapping MinReplicatedDelta;
 	
 	UPROPERTY(BlueprintReadWrite, ReplicatedUsing = OnRep_CurrentActor, Category = "MapEditor | Selection")
 	AActor* CurrentActor;
 	UFUNCTION()
 	void OnRep_CurrentActor();
 	FTransform CurrentActorTransform;
+
+	// CurrentActor is the last selected actor, the gizmo works on the pivot of all of them
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor | Selection")
+	TArray<AActor*> SelectedActors;
+	FMapEditorGroupDelta GroupDelta;
+	bool bGroupDeltaPending;
+	// Only a gizmo drag of several actors is sent as a group delta, everything else per actor
+	bool bGroupEditActive;
+
+	// Set by the server after a group duplicate, so the owner selects the copies
+	UPROPERTY(ReplicatedUsing = OnRep_DuplicatedActors)
+	TArray<AActor*> DuplicatedActors;
+	UFUNCTION()
+	void OnRep_DuplicatedActors();
 	
 	TWeakObjectPtr<APawn> ReturnPawn;
 
 	UPROPERTY(BlueprintReadOnly, Category = "MapEditor | Edit")
 	FMapEditorSnapping SnapAmount;
 
-	TArray<FMapEditorSteps> UndoSteps;
+	UPROPERTY(EditDefaultsOnly, Category = "MapEditor | Edit")
+	int32 MaxUndoSteps;
+	// Only used on the server, clients undo and redo by command id
+	UPROPERTY()
+	FMapEditorJournal Journal;
+	UPROPERTY(Replicated)
+	int32 UndoCommandId;
+	UPROPERTY(Replicated)
+	int32 RedoCommandId;
+	TMap<TWeakObjectPtr<AActor>, FMapEditorNetTransform> EditStartTransforms;
+
+	void BeginEdit(AActor* Actor);
+	void EndEdit(AActor* Actor);
+	void EndEdits(const TArray<AActor*>& Actors);
+	void UpdateJournalIds();
+	void ResetJournal();
+	bool ApplyCommand(FMapEditorCommand& Command, bool bUndo);
+	AActor* RespawnActor(FMapEditorCommandEntry& Entry, const FMapEditorNetTransform& Transform);
+	AActor* SpawnActorInternal(TSubclassOf<AActor> ActorClass, const FTransform& Transform, EMapEditorCommandType CommandType);
+	void DeleteActorsInternal(const TArray<AActor*>& Actors);
+	void ExecuteUndo(int32 CommandId);
+	void ExecuteRedo(int32 CommandId);
 
 	TWeakObjectPtr<AMapEditorGizmo> Gizmo;
+
+	// Server side, the limits are UMapEditorSubsystem::EditLimits and the budgets are kept per controller by the subsystem
+	FMapEditorPlayerBudget* GetPlayerBudget(UMapEditorSubsystem* Subsystem) const;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor | Governor")
+	FMapEditorEditMetrics EditMetrics;
+
+	bool AllowSpawn(UClass* ActorClass, const FTransform& Transform);
+	bool IsSpawnAllowed(UClass* ActorClass, const FVector& Location);
+	bool AllowSpawnBudget(int32 Num);
+	bool AllowTransformUpdate(int32 Num = 1);
+	bool AllowCommit(int32 Num = 1);
+	bool AllowUndo();
+	bool IsEditableActor(const AActor* Actor) const;
+	void FilterEditableActors(const TArray<AActor*>& Actors, TArray<AActor*>& OutActors);
+	FTransform ClampToEditLimits(const FTransform& Transform) const;
+	void RecordEdit(EMapEditorEditResult Result, int32 Count = 1);
+
+	// Latest unsent transform per actor, only the newest is sent each replication interval
+	TMap<TWeakObjectPtr<AActor>, FMapEditorNetTransform> PendingTransforms;
+	TMap<TWeakObjectPtr<AActor>, FMapEditorNetTransform> SentTransforms;
+	FTimerHandle TFlushTransformsHandle;
+	float LastTransformFlushTime;
+
+	FMapEditorSnapping GetReplicationTolerance() const;
+	void QueueTransform(AActor* Actor);
+	void FlushTransforms();
+	void CommitTransform(AActor* Actor);
+	void ScheduleTransformFlush();
+	void BeginGroupEdit();
+	void CommitGroupEdit();
+	void SnapGizmo();
 	
 	// Called when the game starts
 	virtual void BeginPlay() override;
@@ -48,14 +119,40 @@ protected:
 	void SetGizmo();
 
 	UFUNCTION(Server, Unreliable, WithValidation)
-	void Server_ReplicateTransform(AActor* Actor, FTransform Transform);
-
+	void Server_ReplicateNetTransform(AActor* Actor, FMapEditorNetTransform Transform);
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_CommitTransform(AActor* Actor, FMapEditorNetTransform Transform);
 	UFUNCTION(Server, Unreliable, WithValidation)
+	void Server_ReplicateGroupDelta(const TArray<AActor*>& Actors, FMapEditorGroupDelta Delta);
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_CommitGroupDelta(const TArray<AActor*>& Actors, FMapEditorGroupDelta Delta);
+	void ApplyGroupDelta(const TArray<AActor*>& Actors, const FMapEditorGroupDelta& Delta);
+
+	// Everything that records an undo command is reliable, so the owner's undo ids match the journal
+	UFUNCTION(Server, Reliable, WithValidation)
 	void Server_SpawnActor(TSubclassOf<AActor> ActorClass);
-	UFUNCTION(Server, Unreliable, WithValidation)
+	UFUNCTION(Server, Reliable, WithValidation)
 	void Server_SpawnActorAtTransform(TSubclassOf<AActor> ActorClass, const FTransform& Transform);
-	UFUNCTION(Server, Unreliable, WithValidation)
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_DuplicateActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform);
+	UFUNCTION(Server, Reliable, WithValidation)
 	void Server_DeleteActor(AActor* Actor);
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_DuplicateActors(const TArray<AActor*>& Actors, FVector Offset);
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_DeleteActors(const TArray<AActor*>& Actors);
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_Undo(int32 CommandId);
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_Redo(int32 CommandId);
+	// Selects the actors of an undone or redone edit on the owner
+	UFUNCTION(Client, Reliable)
+	void Client_RestoreSelection(const TArray<AActor*>& Actors);
+	// Sent instead of applying a commit the governor dropped, puts the owner back where everyone else sees the actors
+	UFUNCTION(Client, Reliable)
+	void Client_CorrectTransforms(const TArray<AActor*>& Actors, const TArray<FMapEditorNetTransform>& Transforms);
+	void CorrectTransforms(const TArray<AActor*>& Actors);
 	
 	UFUNCTION(Server, Unreliable, WithValidation)
 	void Server_UnpossessToReturnPawn();
@@ -66,6 +163,9 @@ protected:
 	FHitResult MouseTraceMulti(const float Distance, bool& bHitGizmo, const ECollisionChannel CollisionChannel, const bool bDrawDebugLine = false);
 	
 public:
+	// Largest actor array a request may carry, the selection never grows past it
+	static const int32 MaxActorsPerRequest;
+	
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | Initilization")
 	void Init();
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | Initilization")
@@ -84,6 +184,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | Edit")
 	void Undo();
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | Edit")
+	void Redo();
+	UFUNCTION(BlueprintPure, Category = "MapEditor | Edit")
+	bool CanUndo() const { return UndoCommandId != INDEX_NONE; }
+	UFUNCTION(BlueprintPure, Category = "MapEditor | Edit")
+	bool CanRedo() const { return RedoCommandId != INDEX_NONE; }
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Edit")
 	void SetSnapAmount(FMapEditorSnapping SnappingAmounts);
 	UFUNCTION(BlueprintPure, Category = "MapEditor | Edit")
 	FMapEditorSnapping GetSnapAmount() const { return SnapAmount; }
@@ -103,6 +209,27 @@ public:
 	void Grab();
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | Select")
 	void Release();
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Select")
+	void GrabMulti();
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Select")
+	void AddToSelection(AActor* Actor);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Select")
+	void RemoveFromSelection(AActor* Actor);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Select")
+	void SelectActors(const TArray<AActor*>& Actors);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Select")
+	void ClearSelection();
+	// Selects every editable actor within Distance whose location is inside the screen rectangle
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Select")
+	void BoxSelect(FVector2D ScreenStart, FVector2D ScreenEnd, bool bAddToSelection = false, float Distance = 100000.0f);
+	UFUNCTION(BlueprintPure, Category = "MapEditor | Select")
+	const TArray<AActor*>& GetSelectedActors() const { return SelectedActors; }
+	UFUNCTION(BlueprintPure, Category = "MapEditor | Select")
+	FVector GetSelectionPivot() const;
+
+	void MoveSelection(const FVector& Offset);
+	void RotateSelection(const FRotator& Rotation);
+	void ScaleSelection(const FVector& ScaleDelta);
 
 	void ReplicateActor();
 
@@ -5,6 +5,7 @@
 #include "GameFramework/Actor.h"
 #include "Materials/MaterialInterface.h"
 #include "Components/MeshComponent.h"
+#include "Engine/NetSerialization.h"
 #include "MapEditorDataTypes.generated.h"
 
 UENUM(BlueprintType)
@@ -43,6 +44,151 @@ enum class EGizmoType : uint8
 	Scale		UMETA(DisplayName = "Scale")
 };
 
+UENUM(BlueprintType)
+enum class EMapEditorCommandType : uint8
+{
+	None		UMETA(DisplayName = "None"),
+	Move		UMETA(DisplayName = "Move"),
+	Rotate		UMETA(DisplayName = "Rotate"),
+	Scale		UMETA(DisplayName = "Scale"),
+	Spawn		UMETA(DisplayName = "Spawn"),
+	Delete		UMETA(DisplayName = "Delete"),
+	Duplicate	UMETA(DisplayName = "Duplicate")
+};
+
+UENUM(BlueprintType)
+enum class EMapEditorEditResult : uint8
+{
+	Accepted		UMETA(DisplayName = "Accepted"),
+	RateLimited		UMETA(DisplayName = "RateLimited"),
+	OverActorCap	UMETA(DisplayName = "OverActorCap"),
+	ClassNotAllowed	UMETA(DisplayName = "ClassNotAllowed"),
+	OutOfBounds		UMETA(DisplayName = "OutOfBounds"),
+	NotEditable		UMETA(DisplayName = "NotEditable")
+};
+
+// Server side limits for edit requests from clients, a rate of 0 or less is unlimited
+USTRUCT(BlueprintType)
+struct FMapEditorEditLimits
+{
+	GENERATED_BODY()
+	// Spawns and duplicates per player
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	float SpawnsPerSecond;
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	float SpawnBurst;
+	// Unreliable drag updates per player, group updates cost one per actor
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	float TransformsPerSecond;
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	float TransformBurst;
+	// Committed drags and deletes per player, one per actor
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	float CommitsPerSecond;
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	float CommitBurst;
+	// Undo and redo requests per player
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	float UndosPerSecond;
+	// 0 or less for no cap
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	int32 MaxMapActors;
+	// Empty allows every class implementing the map editor interface
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	TArray<TSubclassOf<AActor>> AllowedClasses;
+	// Ignored while invalid, which it is by default
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	FBox EditBounds;
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor")
+	float MaxScale;
+
+	FMapEditorEditLimits()
+	{
+		SpawnsPerSecond = 10.0f;
+		SpawnBurst = 40.0f;
+		TransformsPerSecond = 60.0f;
+		TransformBurst = 120.0f;
+		CommitsPerSecond = 20.0f;
+		CommitBurst = 200.0f;
+		UndosPerSecond = 10.0f;
+		MaxMapActors = 20000;
+		EditBounds = FBox(ForceInit);
+		MaxScale = 100.0f;
+	}
+};
+
+USTRUCT(BlueprintType)
+struct FMapEditorEditMetrics
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	int32 Accepted;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	int32 RateLimited;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	int32 OverActorCap;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	int32 ClassNotAllowed;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	int32 OutOfBounds;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	int32 NotEditable;
+
+	FMapEditorEditMetrics()
+	{
+		Accepted = 0;
+		RateLimited = 0;
+		OverActorCap = 0;
+		ClassNotAllowed = 0;
+		OutOfBounds = 0;
+		NotEditable = 0;
+	}
+
+	void Add(EMapEditorEditResult Result, int32 Count)
+	{
+		switch (Result)
+		{
+		case EMapEditorEditResult::Accepted: Accepted += Count; break;
+		case EMapEditorEditResult::RateLimited: RateLimited += Count; break;
+		case EMapEditorEditResult::OverActorCap: OverActorCap += Count; break;
+		case EMapEditorEditResult::ClassNotAllowed: ClassNotAllowed += Count; break;
+		case EMapEditorEditResult::OutOfBounds: OutOfBounds += Count; break;
+		case EMapEditorEditResult::NotEditable: NotEditable += Count; break;
+		}
+	}
+};
+
+// Token bucket, starts full and refills at Rate per second up to Burst, requests bigger than Burst never fit
+struct FMapEditorRateLimiter
+{
+	float Tokens;
+	double LastTime;
+
+	FMapEditorRateLimiter() : Tokens(-1.0f), LastTime(0.0) {}
+
+	bool Consume(double Now, float Rate, float Burst, float Cost = 1.0f)
+	{
+		if (Rate <= 0.0f) return true;
+
+		Burst = FMath::Max(Burst, 1.0f);
+		Tokens = Tokens < 0.0f ? Burst : FMath::Min(Burst, Tokens + static_cast<float>(Now - LastTime) * Rate);
+		LastTime = Now;
+
+		if (Tokens < Cost) return false;
+		Tokens -= Cost;
+		return true;
+	}
+};
+
+// Request budgets of one player, see UMapEditorSubsystem::GetPlayerBudget
+struct FMapEditorPlayerBudget
+{
+	FMapEditorRateLimiter Spawns;
+	FMapEditorRateLimiter Transforms;
+	FMapEditorRateLimiter Commits;
+	FMapEditorRateLimiter Undos;
+};
+
 USTRUCT(BlueprintType)
 struct FMapEditorSnapping
 {
@@ -68,12 +214,101 @@ struct FMapEditorSnapping
 	}
 };
 
+// Transform sent for edits, quantized to 0.1cm location, 16 bit rotation and 0.01 scale
+USTRUCT()
+struct FMapEditorNetTransform
+{
+	GENERATED_BODY()
+	UPROPERTY()
+	FVector Location;
+	UPROPERTY()
+	FRotator Rotation;
+	UPROPERTY()
+	FVector Scale;
+
+	FMapEditorNetTransform()
+	{
+		Location = FVector::ZeroVector;
+		Rotation = FRotator::ZeroRotator;
+		Scale = FVector::OneVector;
+	}
+	FMapEditorNetTransform(const FTransform& Transform)
+	{
+		Location = Transform.GetLocation();
+		Rotation = Transform.Rotator();
+		Scale = Transform.GetScale3D();
+	}
+
+	FTransform ToTransform() const { return FTransform(Rotation, Location, Scale); }
+
+	bool Equals(const FMapEditorNetTransform& Other, const FMapEditorSnapping& Tolerance) const
+	{
+		return Location.Equals(Other.Location, Tolerance.Location)
+			&& Rotation.Equals(Other.Rotation, Tolerance.Rotation)
+			&& Scale.Equals(Other.Scale, Tolerance.Scale);
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		bOutSuccess = SerializePackedVector<10, 24>(Location, Ar);
+		Rotation.SerializeCompressedShort(Ar);
+		bOutSuccess &= SerializePackedVector<100, 20>(Scale, Ar);
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FMapEditorNetTransform> : public TStructOpsTypeTraitsBase2<FMapEditorNetTransform>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+// Change applied to every selected actor by one group edit, relative to where the edit started
 USTRUCT()
-struct FMapEditorSteps
+struct FMapEditorGroupDelta
 {
 	GENERATED_BODY()
-	AActor* Actor;
-	TArray<FTransform> Transforms;
+	UPROPERTY()
+	FVector_NetQuantize10 Pivot;
+	UPROPERTY()
+	FVector_NetQuantize10 Offset;
+	UPROPERTY()
+	FQuat Rotation;
+	UPROPERTY()
+	FVector_NetQuantize100 Scale;
+
+	FMapEditorGroupDelta()
+	{
+		Reset(FVector::ZeroVector);
+	}
+
+	void Reset(const FVector& NewPivot)
+	{
+		Pivot = NewPivot;
+		Offset = FVector::ZeroVector;
+		Rotation = FQuat::Identity;
+		Scale = FVector::ZeroVector;
+	}
+
+	static FVector ClampScale(FVector NewScale)
+	{
+		if (NewScale.X < 0.0f) NewScale.X = 0.01f;
+		if (NewScale.Y < 0.0f) NewScale.Y = 0.01f;
+		if (NewScale.Z < 0.0f) NewScale.Z = 0.01f;
+		return NewScale;
+	}
+
+	FTransform Apply(const FTransform& Transform) const
+	{
+		FTransform Result = Transform;
+		Result.SetLocation(Pivot + Rotation.RotateVector(Transform.GetLocation() - Pivot) + Offset);
+		Result.SetRotation(Rotation * Transform.GetRotation());
+		Result.SetScale3D(ClampScale(Transform.GetScale3D() + Scale));
+		return Result;
+	}
 };
 
 USTRUCT(BlueprintType)
@@ -104,4 +339,161 @@ struct FMapEditorItems
 	GENERATED_BODY()
 	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
 	TArray<FMapEditorItem> Items;
+};
+
+// Items of a map grouped by the streaming cell they are in
+USTRUCT(BlueprintType)
+struct FMapEditorMapChunk
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	FIntVector Cell;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	TArray<FMapEditorItem> Items;
+
+	FMapEditorMapChunk()
+	{
+		Cell = FIntVector::ZeroValue;
+	}
+
+	FVector GetCenter(float CellSize) const
+	{
+		return (FVector(Cell) + FVector(0.5f)) * CellSize;
+	}
+};
+
+// Catalogue entry for one map file
+USTRUCT(BlueprintType)
+struct FMapEditorMapInfo
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	FString MapName;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	FString LevelName;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	FString FileName;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	int64 FileSize;
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	FDateTime Timestamp;
+	// INDEX_NONE when the file could not be read
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor")
+	int32 ItemCount;
+
+	FMapEditorMapInfo()
+	{
+		FileSize = 0;
+		ItemCount = INDEX_NONE;
+	}
+};
+
+// One actor changed by a journal command, materials are only kept for deleted actors
+USTRUCT()
+struct FMapEditorCommandEntry
+{
+	GENERATED_BODY()
+	UPROPERTY()
+	TWeakObjectPtr<AActor> Actor;
+	UPROPERTY()
+	TSubclassOf<AActor> ActorClass;
+	UPROPERTY()
+	FMapEditorNetTransform Before;
+	UPROPERTY()
+	FMapEditorNetTransform After;
+	UPROPERTY()
+	TArray<UMaterialInterface*> Materials;
+};
+
+USTRUCT()
+struct FMapEditorCommand
+{
+	GENERATED_BODY()
+	UPROPERTY()
+	int32 Id;
+	UPROPERTY()
+	EMapEditorCommandType Type;
+	UPROPERTY()
+	TArray<FMapEditorCommandEntry> Entries;
+
+	FMapEditorCommand()
+	{
+		Id = INDEX_NONE;
+		Type = EMapEditorCommandType::None;
+	}
+};
+
+// Bounded undo/redo history, the oldest command is overwritten once it is full
+USTRUCT()
+struct FMapEditorJournal
+{
+	GENERATED_BODY()
+	UPROPERTY()
+	TArray<FMapEditorCommand> Commands;
+	int32 Capacity;
+	int32 Start;
+	int32 UndoNum;
+	int32 RedoNum;
+	int32 NextId;
+
+	FMapEditorJournal()
+	{
+		Capacity = 100;
+		Start = 0;
+		UndoNum = 0;
+		RedoNum = 0;
+		NextId = 0;
+	}
+
+	void SetCapacity(int32 NewCapacity)
+	{
+		Commands.Empty();
+		Capacity = FMath::Max(NewCapacity, 1);
+		Start = 0;
+		UndoNum = 0;
+		RedoNum = 0;
+	}
+
+	FMapEditorCommand& Record(EMapEditorCommandType Type)
+	{
+		RedoNum = 0;
+		if (UndoNum == Capacity)
+		{
+			Start = (Start + 1) % Capacity;
+			--UndoNum;
+		}
+		
+		const int32 Index = (Start + UndoNum) % Capacity;
+		if (Index == Commands.Num())
+		{
+			Commands.AddDefaulted();
+		}
+		++UndoNum;
+		
+		FMapEditorCommand& Command = Commands[Index];
+		Command.Id = NextId++;
+		Command.Type = Type;
+		Command.Entries.Reset();
+		return Command;
+	}
+
+	FMapEditorCommand* PeekUndo() { return UndoNum > 0 ? &Commands[(Start + UndoNum - 1) % Capacity] : nullptr; }
+	FMapEditorCommand* PeekRedo() { return RedoNum > 0 ? &Commands[(Start + UndoNum) % Capacity] : nullptr; }
+	void PopUndo() { --UndoNum; ++RedoNum; }
+	void PopRedo() { ++UndoNum; --RedoNum; }
+
+	// Commands keep pointing at the same actor after it was respawned by undo or redo
+	void RemapActor(const TWeakObjectPtr<AActor>& OldActor, AActor* NewActor)
+	{
+		for (FMapEditorCommand& Command : Commands)
+		{
+			for (FMapEditorCommandEntry& Entry : Command.Entries)
+			{
+				if (Entry.Actor == OldActor)
+				{
+					Entry.Actor = NewActor;
+				}
+			}
+		}
+	}
 };
\ No newline at end of file
@@ -50,6 +50,7 @@ protected:
 	
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	EMoveAxis GetMoveAxis(UPrimitiveComponent* HitComponent);
 	ERotationAxis GetRotationAxis(UPrimitiveComponent* HitComponent);
@@ -80,12 +81,19 @@ protected:
 
 	bool bGrabbed;
 
+	// Snapping is read once per drag instead of on every axis test
+	FMapEditorSnapping DragSnap;
+	float InvLocationSnap;
+
+	TWeakObjectPtr<USceneComponent> ViewComponent;
+	void TrackView();
+	void OnViewMoved(USceneComponent* Component, EUpdateTransformFlags UpdateFlags, ETeleportType Teleport);
+	void UpdateGizmoScale();
+
 	FTimerHandle TReplicateHandle;
 	void Replicate();
 
 	bool IsRightOfActor();
-
-	bool GreaterThanSnapAmount(float Current, float New);
 	
 public:
 	virtual void Tick(float DeltaSeconds) override;
@@ -0,0 +1,67 @@
+// Copyright 2021, Dakota Dawe, All rights reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Misc/Optional.h"
+#include "Async/Future.h"
+#include "MapEditorDataTypes.h"
+#include "MapEditorMapCatalog.generated.h"
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FMapEditorMapListCompleted, const TArray<FMapEditorMapInfo>&, Maps);
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FMapEditorMapSaveCompleted, bool, bSuccess, const FString&, FullMapName);
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(FMapEditorMapLoadCompleted, bool, bSuccess, const FMapEditorItems&, MapItems, const FString&, FullMapName);
+
+// Cached list of map files per directory, file access runs on the thread pool and completes on the game thread
+UCLASS()
+class MAPEDITOR_API UMapEditorMapCatalog : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	// Directory -> file name -> info
+	TMap<FString, TMap<FString, FMapEditorMapInfo>> Directories;
+	// Saves and deletes made through the catalog, they win over a scan that started before them
+	struct FMapChange
+	{
+		uint64 Serial;
+		TOptional<FMapEditorMapInfo> Info;
+	};
+	TMap<FString, TMap<FString, FMapChange>> Changes;
+	uint64 ChangeSerial = 0;
+	// File path -> last save started for it, the next save of the same file waits for it
+	TMap<FString, TFuture<void>> PendingSaves;
+
+	void RecordChange(const FString& Directory, const FString& FileName, const FMapEditorMapInfo* Info);
+
+	static FString GetDirectoryKey(const FString& MapDirectory);
+	static int32 ReadItemCount(const TCHAR* FilePath);
+
+public:
+	static UMapEditorMapCatalog* Get(const UObject* WorldContextObject);
+	static FMapEditorMapInfo MakeMapInfo(const FString& FileName, int64 FileSize, const FDateTime& Timestamp, int32 ItemCount);
+
+	virtual void Deinitialize() override;
+
+	// Only files changed since the last scan are opened, the files found are the list except for saves and deletes made while scanning
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	void RefreshMapList(const FString& MapDirectory, const FString& LevelName, FMapEditorMapListCompleted OnCompleted);
+	UFUNCTION(BlueprintPure, Category = "MapEditor | FileHandling")
+	bool HasMapList(const FString& MapDirectory) const;
+	// An empty level name returns the maps of every level
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	TArray<FMapEditorMapInfo> GetMapList(const FString& MapDirectory, const FString& LevelName) const;
+	void UpdateMap(const FString& MapDirectory, const FMapEditorMapInfo& Info);
+	void RemoveMap(const FString& MapDirectory, const FString& FileName);
+	// The next list of the directory reads it in full
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	void InvalidateMapList(const FString& MapDirectory);
+
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	void SaveLevelAsync(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, FMapEditorMapSaveCompleted OnCompleted, bool bCompress = true);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	void SaveMapItemsAsync(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, const FMapEditorItems& MapItems, FMapEditorMapSaveCompleted OnCompleted, bool bCompress = true);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	void LoadMapItemsAsync(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, FMapEditorMapLoadCompleted OnCompleted);
+};
\ No newline at end of file
@@ -7,6 +7,22 @@
 #include "MapEditorDataTypes.h"
 #include "MapEditorStatics.generated.h"
 
+struct FMapEditorMapRecord
+{
+	int32 ClassIndex = INDEX_NONE;
+	FTransform Transform;
+	TArray<int32> MaterialIndices;
+};
+
+// Map file contents with object paths left unresolved, so it can be built and written on any thread
+struct FMapEditorMapFile
+{
+	TArray<FString> Paths;
+	TArray<FMapEditorMapRecord> Records;
+	// Set instead of the records for maps saved before the binary format
+	FString LegacyJson;
+};
+
 /**
  * 
  */
@@ -17,6 +33,23 @@ class MAPEDITOR_API UMapEditorStatics : public UBlueprintFunctionLibrary
 public:
 	static FString EncodeString(const FString& StringToEncode);
 	static FString DecodeString(const FString& StringToEncode);
+
+	// Binary .skmap format, maps saved before it are Base64 encoded json
+	static bool GetMapItems(AActor* WorldActor, FMapEditorItems& MapItems);
+	static FMapEditorItem MakeMapItem(const AActor* Actor);
+	static FIntVector GetMapCell(const FVector& Location, float CellSize);
+	static void MakeMapChunks(const FMapEditorItems& MapItems, float CellSize, TArray<FMapEditorMapChunk>& OutChunks);
+	static bool WriteMapItems(const FMapEditorItems& MapItems, TArray<uint8>& OutData, bool bCompress = true);
+	static bool ReadMapItems(const TArray<uint8>& Data, FMapEditorItems& OutMapItems);
+	static bool IsBinaryMap(const TArray<uint8>& Data);
+	static bool ReadMapHeader(FArchive& Reader, uint16& OutVersion, uint8& OutFlags, int32& OutUncompressedSize, int32& OutItemNum);
+	// Encode and Resolve touch UObjects and run on the game thread, Write and Decode are safe on any thread
+	static void EncodeMapItems(const FMapEditorItems& MapItems, FMapEditorMapFile& OutFile);
+	static bool WriteMapFile(const FMapEditorMapFile& File, TArray<uint8>& OutData, bool bCompress = true);
+	static bool DecodeMapFile(const TArray<uint8>& Data, FMapEditorMapFile& OutFile);
+	static bool ResolveMapFile(const FMapEditorMapFile& File, FMapEditorItems& OutMapItems);
+	static int32 GetMapFileItemCount(const FMapEditorMapFile& File);
+	static FString GetMapFilePath(const UWorld* World, const FString& MapDirectory, const FString& MapName, FString& FullMapName);
 	
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | Serialization")
 	static FString SerializeLevel(AActor* WorldActor, bool& Success);
@@ -24,6 +57,7 @@ public:
 	static FMapEditorItems DeSerializeLevel(const FString& JsonString, bool& Success);
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | Map")
 	static void SpawnMapItems(AActor* WorldActor, FMapEditorItems MapItems);
+	static void ApplyItemMaterials(AActor* Actor, const FMapEditorItem& Item);
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | Map")
 	static void SpawnMapItemsFromJson(AActor* WorldActor, const FString& JsonString);
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | Map")
@@ -34,8 +68,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
 	static bool SaveMapToFile(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, const FString& StringToSave, FString& FullMapName);
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	static bool SaveLevelToFile(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, FString& FullMapName, bool bCompress = true);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	static bool SaveMapItemsToFile(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, const FMapEditorItems& MapItems, FString& FullMapName, bool bCompress = true);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	static bool LoadMapItemsFromFile(AActor* WorldActor, const FString& MapDirectory, const FString& MapName, FMapEditorItems& MapItems, FString& FullMapName);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
 	static bool DoesMapExist(AActor* WorldActor, const FString& MapDirectory, const FString& MapName);
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
+	static bool DeleteMap(AActor* WorldActor, const FString& MapDirectory, const FString& MapName);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
 	static FString GetRealMapName(const FString& MapName);
 	UFUNCTION(BlueprintCallable, Category = "MapEditor | FileHandling")
 	static TArray<FString> GetMapList(AActor* WorldActor, const FString& MapDirectory, bool bCutLevelname = true, bool bShowAllMaps = false);
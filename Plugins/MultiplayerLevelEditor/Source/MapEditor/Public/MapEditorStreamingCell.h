@@ -0,0 +1,25 @@
+// Copyright 2021, Dakota Dawe, All rights reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "MapEditorStreamingCell.generated.h"
+
+// Server only owner of the map actors in one streaming cell, gates their replication per connection until the cell is released
+UCLASS(NotBlueprintable, Transient)
+class MAPEDITOR_API AMapEditorStreamingCell : public AActor
+{
+	GENERATED_BODY()
+	
+public:
+	AMapEditorStreamingCell();
+
+	FIntVector Cell;
+	FBox Bounds;
+	// Largest cull distance of the owned actors, distance culling is done per cell
+	float NetCullDistanceSquared;
+	TArray<TWeakObjectPtr<AActor>> Actors;
+
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+};
\ No newline at end of file
@@ -0,0 +1,182 @@
+// Copyright 2021, Dakota Dawe, All rights reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MapEditorDataTypes.h"
+#include "MapEditorSubsystem.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FMapEditorLoadProgress, int32, LoadedItems, int32, TotalItems);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FMapEditorLoadCompleted);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMapEditorClientSynced, APlayerController*, PlayerController);
+
+class AMapEditorStreamingCell;
+class AGameModeBase;
+
+// Bounds of an indexed actor and the range of cells it was inserted into
+struct FMapEditorIndexEntry
+{
+	FBox Bounds;
+	FIntVector MinCell;
+	FIntVector MaxCell;
+
+	FMapEditorIndexEntry() : Bounds(ForceInit), MinCell(FIntVector::ZeroValue), MaxCell(FIntVector::ZeroValue) {}
+};
+
+// Streaming cells a joining client has been sent so far
+struct FMapEditorClientStream
+{
+	TWeakObjectPtr<APlayerController> PlayerController;
+	TSet<FIntVector> ReleasedCells;
+	// Bytes the client may still be sent, goes below zero when a cell is larger than what was left
+	float ByteBudget;
+	bool bSynced;
+
+	FMapEditorClientStream() : ByteBudget(0.0f), bSynced(false) {}
+};
+
+UCLASS()
+class MAPEDITOR_API UMapEditorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UMapEditorSubsystem();
+
+	static const FName PooledTag;
+
+protected:
+	// Items still to be placed by the current load
+	TArray<FMapEditorItem> PendingItems;
+	int32 PendingIndex;
+	bool bLoadingMap;
+
+	// Actors of the previous map that can be re-transformed instead of respawned
+	TMap<TWeakObjectPtr<UClass>, TArray<TWeakObjectPtr<AActor>>> ReusableActors;
+	TMap<TWeakObjectPtr<UClass>, TArray<TWeakObjectPtr<AActor>>> ActorPool;
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	AActor* AcquireActor(UClass* ActorClass, const FTransform& Transform);
+	void FinishMapLoad();
+
+	// Uniform grid over the bounds of every editable actor, so editing never walks the whole world
+	TMap<FIntVector, TArray<TWeakObjectPtr<AActor>>> Cells;
+	TMap<TWeakObjectPtr<AActor>, FMapEditorIndexEntry> IndexedActors;
+	FDelegateHandle ActorSpawnedHandle;
+
+	FIntVector GetCell(const FVector& Location) const;
+	void InsertIntoCells(AActor* Actor, const FMapEditorIndexEntry& Entry);
+	void RemoveFromCells(AActor* Actor, const FMapEditorIndexEntry& Entry);
+	void OnActorSpawned(AActor* Actor);
+	void OnActorTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateFlags, ETeleportType Teleport);
+	UFUNCTION()
+	void OnIndexedActorDestroyed(AActor* Actor);
+
+	// Server only, map actors are owned by the cell they are in and replicate once it is released to a connection
+	TMap<FIntVector, TWeakObjectPtr<AMapEditorStreamingCell>> StreamingCells;
+	TMap<TWeakObjectPtr<const AActor>, FMapEditorClientStream> ClientStreams;
+	TMap<TWeakObjectPtr<const AActor>, FMapEditorPlayerBudget> PlayerBudgets;
+	FDelegateHandle PostLoginHandle;
+	FDelegateHandle LogoutHandle;
+
+	void TickMapLoad();
+	void TickClientStreams(float DeltaTime);
+	bool IsStreamingToClients() const;
+	void UpdateStreamingCell(AActor* Actor);
+	void RemoveFromStreamingCell(AActor* Actor);
+	void OnPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+	void OnLogout(AGameModeBase* GameMode, AController* Exiting);
+
+public:
+	UPROPERTY(BlueprintAssignable, Category = "MapEditor | Map")
+	FMapEditorLoadProgress OnMapLoadProgress;
+	UPROPERTY(BlueprintAssignable, Category = "MapEditor | Map")
+	FMapEditorLoadCompleted OnMapLoaded;
+	// Server side, a client that joined during the session has been sent every cell
+	UPROPERTY(BlueprintAssignable, Category = "MapEditor | Streaming")
+	FMapEditorClientSynced OnClientMapSynced;
+	// Server side, the map was replaced or cleared, anything still pointing at its actors has to let go
+	FSimpleMulticastDelegate OnMapReset;
+
+	// Milliseconds per frame spent placing map items
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor | Map")
+	float SpawnTimeBudget;
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor | Map")
+	int32 MaxPooledActorsPerClass;
+	// Edge length of the spatial index cells, only takes effect before actors are registered
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor | Index")
+	float IndexCellSize;
+	// Edge length of the cells maps are loaded and streamed to joining clients in
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor | Streaming")
+	float StreamCellSize;
+	// Bandwidth each joining client is streamed the map with, whole cells are released once the budget covers them
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor | Streaming")
+	float StreamBytesPerSecond;
+	// Estimated bytes it takes to replicate a map actor to a client for the first time
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor | Streaming")
+	int32 StreamBytesPerActor;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return bLoadingMap || IsStreamingToClients(); }
+	virtual TStatId GetStatId() const override;
+
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Map")
+	void LoadMap(const FMapEditorItems& MapItems);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Map")
+	void CancelMapLoad();
+	UFUNCTION(BlueprintPure, Category = "MapEditor | Map")
+	bool IsLoadingMap() const { return bLoadingMap; }
+
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Map")
+	void ReleaseActor(AActor* Actor);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Map")
+	void ClearPool();
+	UFUNCTION(BlueprintPure, Category = "MapEditor | Map")
+	static bool IsPooled(const AActor* Actor) { return Actor && Actor->ActorHasTag(PooledTag); }
+
+	// Editable actors register themselves on spawn, calling these is only needed for actors the index can't see
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Index")
+	void RegisterActor(AActor* Actor);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Index")
+	void UnregisterActor(AActor* Actor);
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Index")
+	void UpdateActor(AActor* Actor);
+
+	// All registered actors that are part of the map, pooled actors are skipped
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Index")
+	void GetEditableActors(TArray<AActor*>& OutActors) const;
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Index")
+	void GetActorsInBox(const FBox& Box, TArray<AActor*>& OutActors) const;
+	// Closest editable actor hit by the segment, only the actors in the cells along it and the world up to the hit are traced
+	bool PickActor(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, FHitResult& OutHit, const AActor* IgnoredActor = nullptr) const;
+	int32 GetNumIndexedActors() const { return IndexedActors.Num(); }
+	// Registered and not sitting in the pool
+	bool IsMapActor(AActor* Actor) const { return IsValid(Actor) && !IsPooled(Actor) && IndexedActors.Contains(Actor); }
+
+	bool IsCellRelevantFor(const FIntVector& Cell, const AActor* Viewer) const;
+
+	// Server side limits applied to edit requests from clients, see UMapEditorHandlerComponent
+	UPROPERTY(BlueprintReadWrite, Category = "MapEditor | Governor")
+	FMapEditorEditLimits EditLimits;
+	// Totals over all players
+	UPROPERTY(BlueprintReadOnly, Category = "MapEditor | Governor")
+	FMapEditorEditMetrics EditMetrics;
+
+	bool IsClassAllowed(const UClass* ActorClass) const;
+	bool IsInEditBounds(const FVector& Location) const;
+	FTransform ClampToEditLimits(const FTransform& Transform) const;
+	bool IsBelowActorCap(int32 NumNewActors) const;
+	// Kept per controller so recreating the editor pawn or its handler doesn't refill the buckets
+	FMapEditorPlayerBudget& GetPlayerBudget(const AController* Controller) { return PlayerBudgets.FindOrAdd(Controller); }
+	UFUNCTION(BlueprintPure, Category = "MapEditor | Governor")
+	int32 GetNumMapActors() const;
+	UFUNCTION(BlueprintCallable, Category = "MapEditor | Governor")
+	void ResetEditMetrics() { EditMetrics = FMapEditorEditMetrics(); }
+	UFUNCTION(BlueprintPure, Category = "MapEditor | Streaming")
+	bool IsClientSynced(const APlayerController* PlayerController) const;
+};